@@ -0,0 +1,778 @@
+#include "bank_generator.hpp"
+#include "battery.hpp"
+#include "bench.hpp"
+#include "constants.hpp"
+#include "dial.hpp"
+#include "files.hpp"
+#include "grid_generator.hpp"
+#include "map.hpp"
+#include "numeric.hpp"
+#include "paper_removal.hpp"
+#include "range.hpp"
+#include "rotation_format.hpp"
+#include "thread_pool.hpp"
+
+#include <bitset>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Benchmarks for each day's hot path.
+ *  - Every benchmark runs on the real input and on a synthetic input
+ *    built by repeating the real one --scale=<n> times (default 1000).
+ *    Benchmarks that enumerate every day 2 ID use --enumeration_scale=<n>
+ *    (default 10) instead, at 1000 an iteration walks billions of IDs.
+ *  - Synthetic inputs are also written to the temp directory so that
+ *    read_file is measured against a file of the scaled size.
+ *  - Day 4 is also measured on a generated --grid=<n> square map (default
+ *    10000), against the byte per cell layout it replaced.
+ *  - Inputs are built the first time a benchmark needs them, so a run
+ *    narrowed with --filter only pays for the inputs it uses.
+ */
+
+// Value built on first use and shared by every benchmark holding it
+template <typename T>
+class Lazy
+{
+    private:
+    std::function<T()> m_build;
+    std::optional<T>   m_value{};
+
+    public:
+    explicit Lazy( std::function<T()> build ) : m_build( std::move( build ) ) {}
+
+    const T & get() {
+        if ( !m_value )
+            m_value.emplace( m_build() );
+        return *m_value;
+    }
+};
+
+template <typename F>
+auto
+make_lazy( F && build ) {
+    return std::make_shared<Lazy<std::invoke_result_t<F>>>(
+        std::forward<F>( build ) );
+}
+
+struct BenchInput
+{
+    std::string                        label;
+    std::shared_ptr<Lazy<std::string>> lazy_text;
+    std::filesystem::path              path;
+
+    [[nodiscard]] const std::string & text() const { return lazy_text->get(); }
+};
+
+// Repeats every record of input, joined by delim, scale times
+std::string
+repeat_records( const std::string_view input, const char delim,
+                const std::uint64_t scale ) {
+    auto trimmed{ input };
+    while ( !trimmed.empty() && std::isspace( trimmed.back() ) ) {
+        trimmed.remove_suffix( 1 );
+    }
+
+    std::string result{};
+    result.reserve( ( trimmed.size() + 1 ) * scale );
+    for ( std::uint64_t i{ 0 }; i < scale; ++i ) {
+        result += trimmed;
+        result += delim;
+    }
+    return result;
+}
+
+// Tiles a grid into roughly square blocks, scale copies in total
+std::string
+tile_grid( const std::string_view input, const std::uint64_t scale ) {
+    auto rows_repeat{ static_cast<std::uint64_t>(
+        std::sqrt( static_cast<double>( scale ) ) ) };
+    while ( scale % rows_repeat != 0 ) { --rows_repeat; }
+    const auto columns_repeat{ scale / rows_repeat };
+
+    const auto rows{ split_input( input )
+                     | std::views::filter(
+                         []( const auto row ) { return !row.empty(); } )
+                     | std::ranges::to<std::vector<std::string_view>>() };
+
+    std::string result{};
+    result.reserve( input.size() * scale );
+    for ( std::uint64_t i{ 0 }; i < rows_repeat; ++i ) {
+        for ( const auto row : rows ) {
+            for ( std::uint64_t j{ 0 }; j < columns_repeat; ++j ) {
+                result += row;
+            }
+            result += '\n';
+        }
+    }
+    return result;
+}
+
+std::string
+real_text( const std::uint32_t day_no ) {
+    return std::string{ get_input_file( day_no ).view() };
+}
+
+// Input scaled by synthesise( real text, scale ), written to the temp
+// directory when it is built
+BenchInput
+synthetic_input( const std::uint32_t day_no, const std::uint64_t scale,
+                 std::function<std::string( std::string_view, std::uint64_t )>
+                     synthesise ) {
+    const auto path{ std::filesystem::temp_directory_path()
+                     / std::format( "aoc2025_day{}_x{}.txt", day_no, scale ) };
+    return BenchInput{
+        std::format( "x{}", scale ),
+        make_lazy( [=] {
+            auto text{ synthesise( real_text( day_no ), scale ) };
+            std::ofstream( path, std::ios::binary ) << text;
+            return text;
+        } ),
+        path
+    };
+}
+
+BenchInput
+real_input( const std::uint32_t day_no ) {
+    return BenchInput{ "real",
+                       make_lazy( [day_no] { return real_text( day_no ); } ),
+                       input_file_path( day_no ) };
+}
+
+// Records of the real input repeated, joined by delim
+std::vector<BenchInput>
+bench_inputs( const std::uint32_t day_no, const char delim,
+              const std::uint64_t scale ) {
+    return { real_input( day_no ),
+             synthetic_input(
+                 day_no,
+                 scale,
+                 [delim]( const std::string_view text,
+                          const std::uint64_t    n ) {
+                     return repeat_records( text, delim, n );
+                 } ) };
+}
+
+std::vector<std::string_view>
+non_empty_records( const std::string_view text, const std::string_view delim ) {
+    return split_input( text, delim )
+           | std::views::filter(
+               []( const auto record ) { return !record.empty(); } )
+           | std::ranges::to<std::vector<std::string_view>>();
+}
+
+void
+add_io_benchmarks( BenchSuite & suite, const std::uint32_t day_no,
+                   const std::vector<BenchInput> & inputs,
+                   const std::string_view          delim ) {
+    for ( const auto & input : inputs ) {
+        const auto suffix{ std::format( "day{}/{}", day_no, input.label ) };
+
+        suite.add( "read_file/" + suffix, [&input]( BenchState & state ) {
+            state.set_bytes_processed( input.text().size() );
+            while ( state.keep_running() ) {
+                const auto file{ read_file(
+                    std::filesystem::directory_entry( input.path ) ) };
+                // Touch every page, mapping alone does not read anything
+                const auto view{ file.view() };
+                do_not_optimize(
+                    std::accumulate( view.begin(), view.end(), 0 ) );
+            }
+        } );
+
+        suite.add( "split_input/" + suffix,
+                   [&input, delim]( BenchState & state ) {
+                       state.set_bytes_processed( input.text().size() );
+                       while ( state.keep_running() ) {
+                           do_not_optimize( split_input( input.text(), delim ) );
+                       }
+                   } );
+    }
+}
+
+// Dial benchmarks for one dial size
+template <std::uint32_t Size>
+void
+add_dial_benchmarks( BenchSuite & suite, const BenchInput & input ) {
+    suite.add( std::format( "Dial<{}>::transform/{}", Size, input.label ),
+               [&input]( BenchState & state ) {
+                   const auto lines{ split_input( input.text() ) };
+                   state.set_items_processed( lines.size() );
+
+                   while ( state.keep_running() ) {
+                       const Dial<Size> dial{ lines };
+                       do_not_optimize( dial.passes_zero_count() );
+                   }
+               } );
+
+    suite.add( std::format( "Dial<{}>::transform(span)/{}", Size,
+                            input.label ),
+               [&input]( BenchState & state ) {
+                   std::vector<Rotation> rotations{};
+                   for ( const auto line : split_input( input.text() ) ) {
+                       if ( const auto rotation{
+                                Dial<Size>::parse_rotation( line ) } )
+                           rotations.push_back( *rotation );
+                   }
+                   state.set_items_processed( rotations.size() );
+
+                   while ( state.keep_running() ) {
+                       Dial<Size> dial{};
+                       dial.transform( std::span{ rotations } );
+                       do_not_optimize( dial.passes_zero_count() );
+                   }
+               } );
+
+    suite.add( std::format( "Dial<{}>::transform(span, pool)/{}", Size,
+                            input.label ),
+               [&input]( BenchState & state ) {
+                   std::vector<Rotation> rotations{};
+                   for ( const auto line : split_input( input.text() ) ) {
+                       if ( const auto rotation{
+                                Dial<Size>::parse_rotation( line ) } )
+                           rotations.push_back( *rotation );
+                   }
+                   state.set_items_processed( rotations.size() );
+
+                   ThreadPool pool{};
+                   while ( state.keep_running() ) {
+                       Dial<Size> dial{};
+                       dial.transform( std::span{ rotations }, pool );
+                       do_not_optimize( dial.passes_zero_count() );
+                   }
+               } );
+}
+
+// Decoding the binary rotation format straight into a Dial, per encoding
+void
+add_rotation_format_benchmarks( BenchSuite & suite, const BenchInput & input ) {
+    for ( const auto & [encoding, name] :
+          { std::pair{ RotationEncoding::Int16, "int16" },
+            std::pair{ RotationEncoding::Varint, "varint" } } ) {
+        const auto bytes{ make_lazy( [&input, encoding] {
+            std::vector<Rotation> rotations{};
+            for ( const auto line : split_input( input.text() ) ) {
+                if ( const auto rotation{ Dial<>::parse_rotation( line ) } )
+                    rotations.push_back( *rotation );
+            }
+
+            std::ostringstream out{};
+            write_rotations( out, rotations, encoding );
+            return std::move( out ).str();
+        } ) };
+
+        suite.add( std::format( "RotationView::transform({})/{}", name,
+                                input.label ),
+                   [bytes]( BenchState & state ) {
+                       const std::string_view encoded{ bytes->get() };
+                       state.set_items_processed(
+                           RotationView{ encoded }.size() );
+                       state.set_bytes_processed( encoded.size() );
+
+                       while ( state.keep_running() ) {
+                           Dial<> dial{};
+                           do_not_optimize(
+                               RotationView{ encoded }.transform( dial ) );
+                           do_not_optimize( dial.passes_zero_count() );
+                       }
+                   } );
+    }
+}
+
+// Benchmarks that walk every ID of the input, see --enumeration_scale
+template <Question Q>
+void
+add_range_enumeration_benchmarks( BenchSuite & suite, const BenchInput & input,
+                                  const std::string_view question ) {
+    suite.add(
+        std::format( "Range<{}>::invalid_ids/{}", question, input.label ),
+        [&input]( BenchState & state ) {
+            const auto ranges{ non_empty_records( input.text(), "," )
+                               | std::views::transform(
+                                   []( const auto record ) {
+                                       return Range<Q>{ record };
+                                   } )
+                               | std::ranges::to<std::vector<Range<Q>>>() };
+            state.set_items_processed( std::ranges::fold_left(
+                ranges,
+                std::uint64_t{ 0 },
+                []( const auto sum, const auto & rng ) {
+                    return sum
+                           + ( rng.is_valid() ? rng.last() - rng.first() + 1 :
+                                                0 );
+                } ) );
+
+            while ( state.keep_running() ) {
+                std::uint64_t sum{ 0 };
+                for ( const auto & rng : ranges ) {
+                    const auto invalid_ids{ rng.invalid_ids() };
+                    sum += std::accumulate( invalid_ids.cbegin(),
+                                            invalid_ids.cend(),
+                                            std::uint64_t{ 0 } );
+                }
+                do_not_optimize( sum );
+            }
+        } );
+
+    suite.add(
+        std::format(
+            "Range<{}>::parallel_invalid_id_sum/{}", question, input.label ),
+        [&input]( BenchState & state ) {
+            const auto ranges{ non_empty_records( input.text(), "," )
+                               | std::views::transform(
+                                   []( const auto record ) {
+                                       return Range<Q>{ record };
+                                   } )
+                               | std::ranges::to<std::vector<Range<Q>>>() };
+            state.set_items_processed( std::ranges::fold_left(
+                ranges,
+                std::uint64_t{ 0 },
+                []( const auto sum, const auto & rng ) {
+                    return sum
+                           + ( rng.is_valid() ? rng.last() - rng.first() + 1 :
+                                                0 );
+                } ) );
+
+            ThreadPool pool{};
+            while ( state.keep_running() ) {
+                do_not_optimize( parallel_invalid_id_sum( ranges, pool ) );
+            }
+        } );
+}
+
+template <Question Q>
+void
+add_range_benchmarks( BenchSuite & suite, const BenchInput & input,
+                      const std::string_view question ) {
+    suite.add(
+        std::format( "Range<{}>::invalid_id_sum/{}", question, input.label ),
+        [&input]( BenchState & state ) {
+            const auto ranges{ non_empty_records( input.text(), "," )
+                               | std::views::transform(
+                                   []( const auto record ) {
+                                       return Range<Q>{ record };
+                                   } )
+                               | std::ranges::to<std::vector<Range<Q>>>() };
+            state.set_items_processed( ranges.size() );
+
+            while ( state.keep_running() ) {
+                std::uint64_t sum{ 0 };
+                for ( const auto & rng : ranges ) {
+                    sum += rng.invalid_id_sum();
+                }
+                do_not_optimize( sum );
+            }
+        } );
+}
+
+// Question::Two check copied from the baseline Range, before
+// Range::valid_id became allocation-free: std::pow powers, a digit count
+// that divides by ten per digit and a chunk vector for every divisor of
+// the digit count. Kept as the baseline for the valid_id benchmarks.
+namespace legacy
+{
+
+constexpr auto
+num_digits( std::uint64_t id ) {
+    std::uint64_t digits{ 0 };
+    while ( id != 0 ) {
+        digits++;
+        id /= 10;
+    }
+    return digits;
+}
+
+constexpr auto
+id_subrange( const std::uint64_t id, const std::uint64_t left,
+             const std::uint64_t right ) {
+    const auto n_digits{ num_digits( id ) };
+
+    assert( left <= right );
+    assert( right <= n_digits );
+
+    const auto right_shift_divisor{ static_cast<std::uint64_t>(
+        std::pow( 10, n_digits - right ) ) };
+    const auto shifted_remainder{ static_cast<std::uint64_t>(
+        std::pow( 10, right - left ) ) };
+
+    // Remove rightmost unnecessary digits
+    const auto shifted_id{ id / right_shift_divisor };
+
+    // Retrieve desired digits
+    return shifted_id % shifted_remainder;
+}
+
+constexpr auto
+id_chunks( const std::uint64_t id, const std::uint64_t chunk_size ) {
+    const auto n_digits{ num_digits( id ) };
+    assert( n_digits % chunk_size == 0 );
+
+    std::vector<std::uint64_t> chunks( n_digits / chunk_size );
+
+    for ( std::uint64_t i{ 0 }; i < n_digits / chunk_size; i++ ) {
+        chunks[i] = id_subrange( id, i * chunk_size, ( i + 1 ) * chunk_size );
+    }
+
+    return chunks;
+}
+
+constexpr auto
+valid_id_two( const std::uint64_t id ) {
+    const auto n_digits{ num_digits( id ) };
+
+    // Determine valid divisors
+    const auto divisors{ std::ranges::iota_view( std::uint64_t{ 2 },
+                                                 n_digits + 1 )
+                         | std::views::filter( [&n_digits]( const auto n ) {
+                               return n_digits % n == 0;
+                           } )
+                         | std::ranges::to<std::vector<std::uint64_t>>() };
+
+    // Check all chunks of divisor size for matching patterns
+    for ( const auto divisor : divisors ) {
+        const auto chunks{ id_chunks( id, n_digits / divisor ) };
+
+        const auto invalid_id{ ( chunks | std::views::slide( 2 )
+                                 | std::views::drop_while(
+                                     []( const auto & window ) {
+                                         return window[0] == window[1];
+                                     } ) )
+                                   .empty() };
+
+        if ( invalid_id )
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace legacy
+
+// Compares the per-ID Question::Two check against the legacy one by
+// enumerating every ID of the input. Only meaningful on the real input,
+// the scaled one would take minutes per iteration.
+void
+add_valid_id_benchmarks( BenchSuite & suite, const BenchInput & input ) {
+    const auto intervals = [&input] {
+        return non_empty_records( input.text(), "," )
+               | std::views::transform( []( const auto record ) {
+                     return Range<Question::Two>{ record };
+                 } )
+               | std::views::filter(
+                   []( const auto & rng ) { return rng.is_valid(); } )
+               | std::ranges::to<std::vector<Range<Question::Two>>>();
+    };
+    const auto id_count = []( const auto & ranges ) {
+        return std::ranges::fold_left(
+            ranges,
+            std::uint64_t{ 0 },
+            []( const auto sum, const auto & rng ) {
+                return sum + rng.last() - rng.first() + 1;
+            } );
+    };
+
+    suite.add( "Range<Two>::valid_id/" + input.label,
+               [intervals, id_count]( BenchState & state ) {
+                   const auto ranges{ intervals() };
+                   state.set_items_processed( id_count( ranges ) );
+
+                   while ( state.keep_running() ) {
+                       std::uint64_t sum{ 0 };
+                       for ( const auto & rng : ranges ) {
+                           sum += Range<Question::Two>::
+                               enumerated_invalid_id_sum( rng.first(),
+                                                          rng.last() );
+                       }
+                       do_not_optimize( sum );
+                   }
+               } );
+
+    suite.add( "legacy_valid_id_two/" + input.label,
+               [intervals, id_count]( BenchState & state ) {
+                   const auto ranges{ intervals() };
+                   state.set_items_processed( id_count( ranges ) );
+
+                   while ( state.keep_running() ) {
+                       std::uint64_t sum{ 0 };
+                       for ( const auto & rng : ranges ) {
+                           for ( auto id{ rng.first() }; id <= rng.last();
+                                 ++id ) {
+                               if ( !legacy::valid_id_two( id ) )
+                                   sum += id;
+                           }
+                       }
+                       do_not_optimize( sum );
+                   }
+               } );
+}
+
+template <unsigned long long N>
+void
+add_bank_benchmarks( BenchSuite & suite, const BenchInput & input ) {
+    suite.add( std::format( "Bank<{}>::process_joltages/{}", N, input.label ),
+               [&input]( BenchState & state ) {
+                   const auto banks{ non_empty_records( input.text(), "\n" ) };
+                   state.set_items_processed( banks.size() );
+
+                   while ( state.keep_running() ) {
+                       joltage_sum_t<N> sum{ 0 };
+                       for ( const auto bank : banks ) {
+                           sum += Bank<N>{ bank }.joltage();
+                       }
+                       do_not_optimize( sum );
+                   }
+               } );
+
+    suite.add( std::format( "Battery<{}>(pool)/{}", N, input.label ),
+               [&input]( BenchState & state ) {
+                   const auto banks{ non_empty_records( input.text(), "\n" ) };
+                   state.set_items_processed( banks.size() );
+
+                   ThreadPool pool{};
+                   while ( state.keep_running() ) {
+                       do_not_optimize(
+                           Battery<N>{ banks, pool }.joltage() );
+                   }
+               } );
+}
+
+// Day 4 accessibility as it was before Map became a bitboard: one byte
+// per cell, walked column by column, every neighbour bounds-checked.
+// Kept as the baseline for the large grid benchmarks.
+std::uint64_t
+legacy_accessible_paper( const std::vector<std::uint8_t> & cells,
+                         const std::uint32_t width, const std::uint32_t height ) {
+    const auto at = [&]( const std::uint32_t i, const std::uint32_t j ) {
+        if ( i >= width || j >= height )
+            throw std::out_of_range( "Cell out of range." );
+        return cells.at( j * width + i );
+    };
+
+    std::uint64_t accessible{ 0 };
+    for ( std::uint32_t i{ 0 }; i < width; ++i ) {
+        for ( std::uint32_t j{ 0 }; j < height; ++j ) {
+            if ( at( i, j ) == 0 )
+                continue;
+
+            std::bitset<8> neighbours{};
+            std::size_t    position{ 0 };
+            for ( const int dj : { -1, 0, 1 } ) {
+                for ( const int di : { -1, 0, 1 } ) {
+                    if ( di == 0 && dj == 0 )
+                        continue;
+                    const auto ni{ static_cast<std::int64_t>( i ) + di };
+                    const auto nj{ static_cast<std::int64_t>( j ) + dj };
+                    neighbours[position++] =
+                        ni >= 0 && nj >= 0 && ni < width && nj < height
+                        && at( static_cast<std::uint32_t>( ni ),
+                               static_cast<std::uint32_t>( nj ) )
+                               != 0;
+                }
+            }
+            accessible += neighbours.count() < 4;
+        }
+    }
+    return accessible;
+}
+
+// Compares Map::find_accessible against the legacy byte grid on a
+// generated size x size map (--grid=<size>, default 10000)
+void
+add_large_grid_benchmarks( BenchSuite & suite, const std::uint32_t size ) {
+    const auto lazy_map{ make_lazy( [size] {
+        std::ostringstream text{};
+        generate_grid( text, size, size, 65, default_generator_seed );
+        return Map{ std::move( text ).str() };
+    } ) };
+    const auto label{ std::format( "{}x{}", size, size ) };
+
+    suite.add( "Map::find_accessible/" + label,
+               [lazy_map]( BenchState & state ) {
+                   const auto * const map{ &lazy_map->get() };
+                   BitGrid            accessible{ map->width(), map->height() };
+                   state.set_items_processed( std::uint64_t{ map->width() }
+                                              * map->height() );
+
+                   while ( state.keep_running() ) {
+                       Map::find_accessible(
+                           map->paper(), accessible, 0, map->height() );
+                       do_not_optimize( accessible.row( 0 ).front() );
+                   }
+               } );
+
+    suite.add( "Map::find_accessible(pool)/" + label,
+               [lazy_map]( BenchState & state ) {
+                   const auto * const map{ &lazy_map->get() };
+                   BitGrid            accessible{ map->width(), map->height() };
+                   ThreadPool         pool{};
+                   state.set_items_processed( std::uint64_t{ map->width() }
+                                              * map->height() );
+
+                   while ( state.keep_running() ) {
+                       do_not_optimize( Map::find_accessible(
+                           map->paper(), accessible, pool ) );
+                   }
+               } );
+
+    suite.add( "PaperRemoval::run/" + label, [lazy_map]( BenchState & state ) {
+        const auto * const map{ &lazy_map->get() };
+
+        state.set_items_processed( std::uint64_t{ map->width() }
+                                   * map->height() );
+
+        while ( state.keep_running() ) {
+            PaperRemoval removal{ *map };
+            do_not_optimize( removal.run() );
+        }
+    } );
+
+    suite.add( "PaperRemoval::run(pool)/" + label,
+               [lazy_map]( BenchState & state ) {
+                   const auto * const map{ &lazy_map->get() };
+                   ThreadPool         pool{};
+                   state.set_items_processed( std::uint64_t{ map->width() }
+                                              * map->height() );
+
+                   while ( state.keep_running() ) {
+                       PaperRemoval removal{ *map };
+                       do_not_optimize( removal.run( pool ) );
+                   }
+               } );
+
+    suite.add(
+        "legacy_accessible_paper/" + label, [lazy_map]( BenchState & state ) {
+            const auto * const        map{ &lazy_map->get() };
+            std::vector<std::uint8_t> cells( std::uint64_t{ map->width() }
+                                             * map->height() );
+            for ( std::uint32_t j{ 0 }; j < map->height(); ++j ) {
+                for ( std::uint32_t i{ 0 }; i < map->width(); ++i ) {
+                    cells[std::uint64_t{ j } * map->width() + i] =
+                        map->is_paper( i, j );
+                }
+            }
+            state.set_items_processed( cells.size() );
+
+            while ( state.keep_running() ) {
+                do_not_optimize( legacy_accessible_paper(
+                    cells, map->width(), map->height() ) );
+            }
+        } );
+}
+
+int
+main( const int argc, char ** argv ) {
+    auto options{ parse_bench_args( argc, argv ) };
+
+    std::uint64_t scale{ 1000 };
+    std::uint64_t enumeration_scale{ 10 };
+    std::uint32_t grid_size{ 10000 };
+    for ( const auto & arg : options.unparsed ) {
+        if ( arg.starts_with( "--scale=" ) )
+            scale = parse::to_number<std::uint64_t>( arg.substr( 8 ) )
+                        .value_or( scale );
+        else if ( arg.starts_with( "--enumeration_scale=" ) )
+            enumeration_scale =
+                parse::to_number<std::uint64_t>( arg.substr( 20 ) )
+                    .value_or( enumeration_scale );
+        else if ( arg.starts_with( "--grid=" ) )
+            grid_size = parse::to_number<std::uint32_t>( arg.substr( 7 ) )
+                            .value_or( grid_size );
+    }
+
+    const auto day1{ bench_inputs( 1, '\n', scale ) };
+    const auto day2{ bench_inputs( 2, ',', scale ) };
+    const auto day2_enumeration{ bench_inputs( 2, ',', enumeration_scale ) };
+    const auto day3{ bench_inputs( 3, '\n', scale ) };
+    const std::vector<BenchInput> day4{ real_input( 4 ),
+                                        synthetic_input( 4, scale, tile_grid ) };
+
+    BenchSuite suite{};
+    suite.add_context( "scale", std::to_string( scale ) );
+    suite.add_context( "enumeration_scale",
+                       std::to_string( enumeration_scale ) );
+    suite.add_context( "grid", std::to_string( grid_size ) );
+
+    add_io_benchmarks( suite, 1, day1, "\n" );
+    add_io_benchmarks( suite, 2, day2, "," );
+    add_io_benchmarks( suite, 3, day3, "\n" );
+    add_io_benchmarks( suite, 4, day4, "\n" );
+
+    for ( const auto & input : day1 ) {
+        add_dial_benchmarks<64>( suite, input );
+        add_dial_benchmarks<100>( suite, input );
+        add_dial_benchmarks<256>( suite, input );
+        add_dial_benchmarks<1000>( suite, input );
+        add_rotation_format_benchmarks( suite, input );
+    }
+
+    for ( const auto & input : day2 ) {
+        add_range_benchmarks<Question::One>( suite, input, "One" );
+        add_range_benchmarks<Question::Two>( suite, input, "Two" );
+    }
+    for ( const auto & input : day2_enumeration ) {
+        add_range_enumeration_benchmarks<Question::One>( suite, input, "One" );
+        add_range_enumeration_benchmarks<Question::Two>( suite, input, "Two" );
+    }
+    add_valid_id_benchmarks( suite, day2.front() );
+
+    for ( const auto & input : day3 ) {
+        add_bank_benchmarks<2>( suite, input );
+        add_bank_benchmarks<12>( suite, input );
+    }
+
+    // Long banks, where the joltage outgrows an unsigned long long
+    const auto long_banks = [] {
+        std::ostringstream text{};
+        generate_banks( text, 1'000, 5'000, default_generator_seed );
+        return std::move( text ).str();
+    };
+    const BenchInput long_bank_input{ "1000x5000", make_lazy( long_banks ),
+                                      {} };
+    add_bank_benchmarks<12>( suite, long_bank_input );
+    add_bank_benchmarks<200>( suite, long_bank_input );
+
+    for ( const auto & input : day4 ) {
+        suite.add( "Map::process_map/" + input.label,
+                   [&input]( BenchState & state ) {
+                       while ( state.keep_running() ) {
+                           const Map map{ input.text() };
+                           state.set_items_processed( map.width()
+                                                      * map.height() );
+                           do_not_optimize( map.accessible_paper() );
+                       }
+                   } );
+
+        suite.add( "PaperRemoval::run/" + input.label,
+                   [&input]( BenchState & state ) {
+                       const Map map{ input.text() };
+                       state.set_items_processed( map.width()
+                                                  * map.height() );
+
+                       while ( state.keep_running() ) {
+                           PaperRemoval removal{ map };
+                           do_not_optimize( removal.run() );
+                       }
+                   } );
+    }
+
+    add_large_grid_benchmarks( suite, grid_size );
+
+    const auto results{ suite.run( options ) };
+    suite.write_json( results, options.json_path );
+}
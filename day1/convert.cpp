@@ -0,0 +1,90 @@
+#include "dial.hpp"
+#include "files.hpp"
+#include "generator.hpp"
+#include "rotation_format.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/*
+ * Converts text rotations (L68, R48, ...) into the binary rotation format.
+ * Usage: day1_convert [--input=path] [--output=path]
+ *                     [--encoding=auto|int16|varint]
+ *  - Input defaults to day1/input.txt. Invalid lines are skipped, as Dial
+ *    skips them.
+ *  - Sizes above UINT32_MAX do not fit a Rotation. Dial skips them too,
+ *    but they are not typos, so converting fails rather than drop them.
+ *  - auto picks int16 when every size fits, varint otherwise.
+ */
+int
+main( const int argc, char ** argv ) {
+    const GeneratorArgs args{ argc, argv };
+
+    const auto      default_input{ input_file_path( 1 ) };
+    const InputFile input{ std::filesystem::path{
+        args.get( "input", std::string_view{ default_input.native() } ) } };
+    // An empty rotation file would pass for a converted empty input
+    if ( input.failed() )
+        return 1;
+
+    // Of a line that parse_rotation rejects, only its size can be at fault
+    const auto is_well_formed = []( const std::string_view line ) {
+        return line.size() > 1 && ( line.front() == 'L' || line.front() == 'R' )
+               && std::ranges::all_of( line.substr( 1 ), []( const char c ) {
+                      return c >= '0' && c <= '9';
+                  } );
+    };
+
+    std::vector<Rotation> rotations{};
+    std::uint64_t         skipped{ 0 };
+    std::uint64_t         line_no{ 0 };
+    for ( const auto line : split_input( input ) ) {
+        ++line_no;
+        if ( const auto rotation{ Dial<>::parse_rotation( line ) } ) {
+            rotations.push_back( *rotation );
+        } else if ( is_well_formed( line ) ) {
+            std::cerr << std::format(
+                "Rotation {} on line {} is larger than UINT32_MAX.",
+                line,
+                line_no ) << std::endl;
+            return 1;
+        } else if ( !line.empty() ) {
+            ++skipped;
+        }
+    }
+    if ( skipped > 0 ) {
+        std::cerr << std::format( "Skipped {} invalid rotations.", skipped )
+                  << std::endl;
+    }
+
+    const auto encoding_name{ args.get( "encoding", "auto" ) };
+    std::optional<RotationEncoding> encoding{};
+    if ( encoding_name == "int16" )
+        encoding = RotationEncoding::Int16;
+    else if ( encoding_name == "varint" )
+        encoding = RotationEncoding::Varint;
+    else if ( encoding_name == "auto" )
+        encoding = fits_int16( rotations ) ? RotationEncoding::Int16 :
+                                             RotationEncoding::Varint;
+
+    if ( !encoding ) {
+        std::cerr << std::format( "Unknown encoding {}.", encoding_name )
+                  << std::endl;
+        return 1;
+    }
+    if ( *encoding == RotationEncoding::Int16 && !fits_int16( rotations ) ) {
+        std::cerr << "Rotations do not fit int16, use --encoding=varint."
+                  << std::endl;
+        return 1;
+    }
+
+    return args.run( [&]( std::ostream & out ) {
+        write_rotations( out, rotations, *encoding );
+    } );
+}
@@ -1,155 +1,27 @@
 #include "constants.hpp"
+#include "dial.hpp"
 #include "files.hpp"
+#include "instrument.hpp"
+#include "rotation_format.hpp"
+#include "thread_pool.hpp"
 
+#include <algorithm>
 #include <cstdint>
-#include <regex>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
 #include <string_view>
+#include <vector>
 
-/*
- * Dial on safe, numbered 0-99 in order.
- * Input:
- *  - Sequence of rotations, e.g: L3, R96, ...
- *  - Pattern: XY.
- *  - X: Letter indicating L -> left, R -> right.
- *  - Y: Number indicating length of rotation.
- *  - E.g. If dial is at 11, 11 + R8 -> 19, 19 + L19 -> 0.
- *  - Dial is circular -> numbers wrap both ways.
- *  - Dial starts at 50.
- *  - The real password is the no. of times the dial is left pointing
- *    at 0 after any rotation in the sequence.
- */
-
-class Dial
-{
-    private:
-    std::uint32_t m_zero_count{ 0 };
-    std::uint32_t m_passes_zero_count{ 0 };
-    std::uint32_t m_position{ 50 };
-
-    struct Transform
-    {
-        bool          is_valid;
-        bool          direction;
-        std::uint32_t size;
-    };
-    void print_transform( const Transform & transform ) {
-        std::println(
-            "Transform {{\n\tis_valid: {},\n\tdirection: {},\n\tsize: {}\n}}",
-            transform.is_valid,
-            ( transform.direction ? "+" : "-" ),
-            transform.size );
-    }
-
-    constexpr auto
-    is_valid_transform( const std::string_view transform ) const noexcept {
-        std::regex valid_transform_regex{ "^([LR])([0-9]+)$" };
-
-        const std::string data{ transform.data(), transform.size() };
-
-        std::smatch result{};
-        if ( std::regex_match(
-                 data.cbegin(), data.cend(), result, valid_transform_regex ) ) {
-            return Transform{ true,
-                              result[1] == std::string{ "R" },
-                              static_cast<std::uint32_t>(
-                                  std::stoul( result[2] ) ) };
-        }
-        else {
-            return Transform{ false, false, 0 };
-        }
-    };
-
-    constexpr auto passes_zero( const auto & transform ) {
-        return transform.size
-               >= ( transform.direction ? 100 - m_position : m_position );
-    }
-
-    constexpr std::uint32_t zero_passes( const auto & transform ) {
-        if ( !passes_zero( transform ) )
-            return 0;
-
-        // std::println();
-        // std::println( "Counting zero passes..." );
-        // std::println( "current position: {}", m_position );
-        // print_transform( transform );
-
-        const std::uint32_t divisor{ transform.size / 100 };
-        const std::uint32_t remainder{ transform.size % 100 };
-        const std::uint32_t passes{
-            divisor
-            + passes_zero( Transform(
-                transform.is_valid, transform.direction, remainder ) )
-            - ( m_position == 0 && !transform.direction )
-        };
-        // std::println( "divisor: {}, remainder: {}, passes: {}",
-        //               divisor,
-        //               remainder,
-        //               passes );
-        // std::println();
-
-        return passes;
-    }
-
-    public:
-    constexpr Dial() = default;
-    constexpr ~Dial() = default;
-    constexpr Dial( const Dial & ) = default;
-    constexpr Dial( Dial && ) noexcept = default;
-    constexpr Dial & operator=( const Dial & ) = default;
-    constexpr Dial & operator=( Dial && ) noexcept = default;
-
-    constexpr auto transform( const std::string_view raw_transform ) noexcept {
-        auto transform = is_valid_transform( raw_transform );
-        if ( transform.is_valid ) {
-            m_passes_zero_count += zero_passes( transform );
-
-            m_position +=
-                ( transform.direction ? transform.size % 100 :
-                                        100 - ( transform.size % 100 ) );
-            m_position %= 100;
-
-            if ( m_position == 0 )
-                m_zero_count++;
-        }
-        return m_position;
-    }
-
-    constexpr auto
-    transform( const std::vector<std::string_view> & raw_transforms ) noexcept {
-        for ( const auto & raw_transform : raw_transforms ) {
-            transform( raw_transform );
-        }
-        return m_position;
-    }
-    constexpr explicit Dial(
-        const std::vector<std::string_view> & raw_transforms ) {
-        [[maybe_unused]] const auto position{ transform( raw_transforms ) };
-    }
-
-    constexpr auto is_zero() const noexcept { return m_position == 0; }
-    constexpr auto zero_count() const noexcept { return m_zero_count; }
-    constexpr auto passes_zero_count() const noexcept {
-        return m_passes_zero_count;
-    }
-    constexpr auto position() const noexcept { return m_position; }
-    constexpr void reset() noexcept {
-        m_position = 50;
-        m_zero_count = 0;
-        m_passes_zero_count = 0;
-    }
-
-    void position( const std::uint32_t position ) { m_position = position; }
-    void zero_count( const std::uint32_t zero_count ) {
-        m_zero_count = zero_count;
-    }
-    void passes_zero_count( const std::uint32_t passes_zero_count ) {
-        m_passes_zero_count = passes_zero_count;
-    }
-};
+#ifdef AOC_CONSTEVAL
+#include "embedded_input.hpp"
+#endif
 
 constexpr bool
 verify_underflow() {
-    Dial dial{};
+    Dial<> dial{};
 
     std::println( "verify_underflow | initial position: {}", dial.position() );
     dial.transform( "L50" );
@@ -170,7 +42,7 @@ verify_underflow() {
 
 constexpr bool
 verify_overflow() {
-    Dial dial{};
+    Dial<> dial{};
 
     std::println( "verify_overflow | initial position: {}", dial.position() );
     dial.transform( "R50" );
@@ -189,7 +61,7 @@ verify_overflow() {
 
 constexpr bool
 verify_large_overflow() {
-    Dial dial{};
+    Dial<> dial{};
 
     std::println( "verify_large_overflow | initial position: {}",
                   dial.position() );
@@ -204,7 +76,7 @@ verify_large_overflow() {
 
 constexpr bool
 verify_large_underflow() {
-    Dial dial{};
+    Dial<> dial{};
 
     std::println( "verify_large_underflow | initial position: {}",
                   dial.position() );
@@ -219,7 +91,7 @@ verify_large_underflow() {
 
 constexpr bool
 verify_underflow_count() {
-    Dial dial{};
+    Dial<> dial{};
     dial.position( 0 );
 
     dial.transform( "L469" );
@@ -229,7 +101,7 @@ verify_underflow_count() {
 
 constexpr bool
 verify_overflow_count() {
-    Dial dial{};
+    Dial<> dial{};
     dial.position( 0 );
 
     dial.transform( "R469" );
@@ -237,6 +109,125 @@ verify_overflow_count() {
     return dial.passes_zero_count() == 4;
 }
 
+constexpr bool
+verify_rotations() {
+    const std::vector<std::string_view> transforms{ "L68", "L30", "R48", "L5",
+                                                    "R60", "L55", "L1",  "L99",
+                                                    "R14", "L82", "R1000",
+                                                    "L250" };
+
+    Dial<>                dial{};
+    std::vector<Rotation> rotations{};
+    for ( const auto transform : transforms ) {
+        dial.transform( transform );
+        rotations.push_back( *Dial<>::parse_rotation( transform ) );
+    }
+
+    Dial<> batched{};
+    batched.transform( std::span{ rotations } );
+
+    return batched.position() == dial.position()
+           && batched.zero_count() == dial.zero_count()
+           && batched.passes_zero_count() == dial.passes_zero_count();
+}
+
+bool
+verify_parallel_rotations() {
+    const std::vector<std::string_view> transforms{ "L68", "L30", "R48", "L5",
+                                                    "R60", "L55", "L1",  "L99",
+                                                    "R14", "L82", "R1000",
+                                                    "L250" };
+
+    Dial<>                dial{};
+    std::vector<Rotation> rotations{};
+    std::string           input{};
+    for ( const auto transform : transforms ) {
+        dial.transform( transform );
+        rotations.push_back( *Dial<>::parse_rotation( transform ) );
+        input += transform;
+        input += '\n';
+    }
+    // Sizes past INT32_MAX, up to UINT32_MAX, are applied by every path
+    for ( const std::string_view transform :
+          { "R3000000000", "L4294967295" } ) {
+        dial.transform( transform );
+        rotations.push_back( *Dial<>::parse_rotation( transform ) );
+        input += transform;
+        input += '\n';
+    }
+    // Too large for a size, skipped by every path
+    dial.transform( "R4294967296" );
+    input += "R4294967296\n";
+
+    const auto matches = [&]( const Dial<> & other ) {
+        return other.position() == dial.position()
+               && other.zero_count() == dial.zero_count()
+               && other.passes_zero_count() == dial.passes_zero_count();
+    };
+
+    // Runs of three, so that runs start away from 50
+    ThreadPool pool{};
+    Dial<>     summarised{};
+    summarised.transform( std::span{ rotations }, pool, 3 );
+
+    bool result{ matches( summarised ) };
+    // Chunks of one byte up to more than the input, so that chunks are cut
+    // within lines, hold several lines or are left empty
+    for ( std::size_t chunk_bytes{ 1 }; chunk_bytes <= input.size() + 1;
+          ++chunk_bytes ) {
+        result &= matches( Dial<>{ input, pool, chunk_bytes } );
+    }
+    return result;
+}
+
+bool
+verify_rotation_format() {
+    const std::vector<std::string_view> transforms{ "L68", "L30", "R48", "L5",
+                                                    "R60", "L55", "L1",  "L99",
+                                                    "R14", "L82", "R1000",
+                                                    "L250" };
+
+    Dial<>                dial{};
+    std::vector<Rotation> rotations{};
+    for ( const auto transform : transforms ) {
+        dial.transform( transform );
+        rotations.push_back( *Dial<>::parse_rotation( transform ) );
+    }
+
+    bool result{ true };
+    for ( const auto encoding :
+          { RotationEncoding::Int16, RotationEncoding::Varint } ) {
+        std::ostringstream out{};
+        write_rotations( out, rotations, encoding );
+        const auto bytes{ out.str() };
+
+        const RotationView decoded{ bytes };
+        Dial<>             binary{};
+        result &= decoded.is_valid() && decoded.size() == rotations.size()
+                  && decoded.transform( binary )
+                  && binary.position() == dial.position()
+                  && binary.zero_count() == dial.zero_count()
+                  && binary.passes_zero_count() == dial.passes_zero_count();
+    }
+
+    // Sizes up to UINT32_MAX only fit the Varint encoding
+    const std::vector<Rotation> large{ { 4294967295 },
+                                       { -4294967295 },
+                                       { -3000000000 } };
+    std::ostringstream          out{};
+    write_rotations( out, large, RotationEncoding::Varint );
+    const auto bytes{ out.str() };
+
+    std::vector<Rotation> decoded{};
+    result &= RotationView{ bytes }.for_each_block(
+        [&]( const std::span<const Rotation> block ) {
+            decoded.insert( decoded.end(), block.begin(), block.end() );
+        } );
+    result &= std::ranges::equal(
+        decoded, large, {}, &Rotation::delta, &Rotation::delta );
+    return result;
+}
+
 constexpr bool
 verify() {
     const std::vector<std::string_view> transforms{ "L68", "L30", "R48", "L5",
@@ -245,7 +236,7 @@ verify() {
     const std::vector<std::uint32_t>    expected_positions{ 82, 52, 0, 95, 55,
                                                          0,  99, 0, 14, 32 };
 
-    Dial dial{};
+    Dial<> dial{};
 
     bool result{ true };
     for ( const auto & [transform, expected_pos] :
@@ -266,21 +257,60 @@ verify() {
     return result && ( dial.zero_count() == 3 );
 }
 
-Dial
-problem_1( const std::vector<std::string_view> & lines ) {
-    Dial dial{ lines };
+// Prints the hot path counters, only when built with AOC_INSTRUMENT
+void
+report_stats( const Dial<> & dial, const std::string_view label ) {
+    instrument( dial.stats(),
+                [label]( const auto & stats ) { stats.report( label ); } );
+}
+
+Dial<>
+problem_1( record_range auto && lines ) {
+    Dial<> dial{ lines };
+    std::println( "zero_count: {}", dial.zero_count() );
+    report_stats( dial, "problem_1" );
+    return dial;
+}
+// The whole input, split and parsed on all cores
+Dial<>
+problem_1( const std::string_view input, ThreadPool & pool ) {
+    Dial<> dial{ input, pool };
     std::println( "zero_count: {}", dial.zero_count() );
+    report_stats( dial, "problem_1" );
     return dial;
 }
-Dial
-problem_2( const Dial & dial ) {
+// Rotations pre-parsed by day1_convert, nullopt if the file is corrupt
+std::optional<Dial<>>
+problem_1( const RotationView & rotations ) {
+    Dial<> dial{};
+    if ( !rotations.transform( dial ) ) {
+        std::println( "Rotation file is corrupt." );
+        return std::nullopt;
+    }
+    std::println( "zero_count: {}", dial.zero_count() );
+    report_stats( dial, "problem_1" );
+    return dial;
+}
+Dial<>
+problem_2( const Dial<> & dial ) {
     std::println( "passes_zero_count: {}", dial.passes_zero_count() );
     return dial;
 }
 
+#ifdef AOC_CONSTEVAL
+// The serial Dial of problem_1, run over the embedded input by the compiler
+consteval Dial<>
+constant_dial() {
+    return Dial<>{ split_input( embedded_input ) };
+}
+
+static_assert( verify_underflow_count() && verify_overflow_count()
+               && verify_rotations() );
+#endif
+
 void
 test() {
-    Dial dial{};
+    Dial<> dial{};
 
     std::println();
     for ( int i{ 0 }; i < 100; ++i ) {
@@ -291,8 +321,22 @@ test() {
     std::println();
 }
 
+// Pass --parallel to evaluate the rotations on all cores. The input is then
+// read whole rather than streamed. Pass --binary=<path> to read rotations
+// converted by day1_convert instead.
 int
-main() {
+main( const int argc, char ** argv ) {
+#ifdef AOC_CONSTEVAL
+    // Everything was computed while compiling
+    constexpr auto constant{ constant_dial() };
+    std::println( "zero_count: {}", constant.zero_count() );
+    std::println( "passes_zero_count: {}", constant.passes_zero_count() );
+    return 0;
+#endif
+
+    const std::string_view option{ argc > 1 ? argv[1] : "" };
+    const bool             parallel{ option == "--parallel" };
+
     // if ( !verify_underflow() ) {
     //     std::println( "Underflow errors detected." );
     //     return 0;
@@ -325,10 +369,50 @@ main() {
         return 0;
     }
 
-    const auto input_file{ get_input_file( 1 ) };
+    if ( !verify_rotations() ) {
+        std::println( "Rotation batch errors." );
+        return 0;
+    }
+
+    if ( !verify_parallel_rotations() ) {
+        std::println( "Parallel rotation errors." );
+        return 0;
+    }
+
+    if ( !verify_rotation_format() ) {
+        std::println( "Rotation format errors." );
+        return 0;
+    }
 
-    const auto lines{ file_lines( input_file ) };
+    if ( option.starts_with( "--binary=" ) ) {
+        const RotationFile file{ std::filesystem::path{
+            option.substr( std::string_view{ "--binary=" }.size() ) } };
+        if ( !file.rotations().is_valid() )
+            return 1;
+
+        const auto dial{ problem_1( file.rotations() ) };
+        if ( !dial )
+            return 1;
+
+        problem_2( *dial );
+        return 0;
+    }
+
+    if ( parallel ) {
+        const auto input{ get_input_file( 1 ) };
+        ThreadPool pool{};
+
+        auto dial{ problem_1( input, pool ) };
+        dial = problem_2( dial );
+        return 0;
+    }
+
+    auto lines{ stream_input_file( 1 ) };
 
     auto dial{ problem_1( lines ) };
     dial = problem_2( dial );
+    if ( lines.failed() ) {
+        std::println( "Input was not read whole, the counts are partial." );
+        return 1;
+    }
 }
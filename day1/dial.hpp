@@ -0,0 +1,547 @@
+#pragma once
+
+#include "files.hpp"
+#include "instrument.hpp"
+#include "parse.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <format>
+#include <optional>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Dial on safe, numbered 0 to Size - 1 in order (0-99 by default).
+ * Input:
+ *  - Sequence of rotations, e.g: L3, R96, ...
+ *  - Pattern: XY.
+ *  - X: Letter indicating L -> left, R -> right.
+ *  - Y: Number indicating length of rotation.
+ *  - E.g. If dial is at 11, 11 + R8 -> 19, 19 + L19 -> 0.
+ *  - Dial is circular -> numbers wrap both ways.
+ *  - Dial starts at Start (50 by default).
+ *  - The real password is the no. of times the dial is left pointing
+ *    at 0 after any rotation in the sequence.
+ */
+
+// A parsed rotation: R<n> is +n, L<n> is -n. Sizes go up to UINT32_MAX,
+// so a delta takes 33 bits.
+struct Rotation
+{
+    std::int64_t delta;
+};
+static_assert( sizeof( Rotation ) == sizeof( std::int64_t ) );
+
+/*
+ * Hot path counters and phase timings of a Dial, only kept when built with
+ * AOC_INSTRUMENT (see instrument.hpp).
+ *  - Parsing is the text to transform step, applying is the position and
+ *    count update. Rotations that arrive pre-parsed only time applying.
+ *  - The parallel paths sum parse time over threads. They do not count
+ *    zero-passing moves, as a chunk's moves are summarised for every
+ *    start position at once, and the report says so.
+ */
+struct DialStats
+{
+    std::uint64_t              parse_failures{ 0 };
+    std::uint64_t              zero_passing_moves{ 0 };
+    std::uint64_t              multi_revolution_moves{ 0 };
+    std::uint64_t              zero_landings{ 0 };
+    instrument_clock::duration parse_time{};
+    instrument_clock::duration apply_time{};
+    bool                       zero_passing_counted{ true };
+
+    constexpr DialStats & operator+=( const DialStats & other ) noexcept {
+        parse_failures += other.parse_failures;
+        zero_passing_moves += other.zero_passing_moves;
+        zero_passing_counted =
+            zero_passing_counted && other.zero_passing_counted;
+        multi_revolution_moves += other.multi_revolution_moves;
+        zero_landings += other.zero_landings;
+        parse_time += other.parse_time;
+        apply_time += other.apply_time;
+        return *this;
+    }
+
+    void report( const std::string_view label ) const {
+        using milliseconds = std::chrono::duration<double, std::milli>;
+        const auto zero_passing{ zero_passing_counted ?
+                                     std::format( "{}", zero_passing_moves ) :
+                                     std::string{ "not counted in parallel" } };
+        std::println( "{} | parse failures: {}, zero-passing moves: {}, "
+                      "multi-revolution moves: {}, zero landings: {}",
+                      label,
+                      parse_failures,
+                      zero_passing,
+                      multi_revolution_moves,
+                      zero_landings );
+        std::println( "{} | parse: {:.3f} ms, apply: {:.3f} ms",
+                      label,
+                      milliseconds{ parse_time }.count(),
+                      milliseconds{ apply_time }.count() );
+    }
+};
+
+template <std::uint32_t Size = 100, std::uint32_t Start = 50>
+    requires( Size > 0 && Start < Size )
+class Dial
+{
+    private:
+    std::uint32_t m_zero_count{ 0 };
+    std::uint32_t m_passes_zero_count{ 0 };
+    std::uint32_t m_position{ Start };
+
+    [[no_unique_address]] Instrumented<DialStats> m_stats{};
+
+    template <typename F>
+    constexpr void record( F && update ) noexcept {
+        instrument( m_stats, std::forward<F>( update ) );
+    }
+
+    static constexpr bool is_multi_revolution( const Rotation rotation ) {
+        return std::abs( rotation.delta ) >= Size;
+    }
+
+    // value % Size and value / Size, a mask and a shift when Size is a
+    // power of two
+    template <std::unsigned_integral T>
+    static constexpr T wrap( const T value ) noexcept {
+        if constexpr ( std::has_single_bit( Size ) )
+            return value & T{ Size - 1 };
+        else
+            return value % Size;
+    }
+    template <std::unsigned_integral T>
+    static constexpr T revolutions( const T value ) noexcept {
+        if constexpr ( std::has_single_bit( Size ) )
+            return value >> std::countr_zero( Size );
+        else
+            return value / Size;
+    }
+
+    // Smallest multiple of Size above limit
+    static constexpr std::uint64_t
+    multiple_above( const std::uint64_t limit ) noexcept {
+        return ( limit / Size + 1 ) * Size;
+    }
+
+    struct Transform
+    {
+        bool          is_valid;
+        bool          direction;
+        std::uint32_t size;
+    };
+
+    // Equivalent to the regex ^([LR])([0-9]+)$
+    using transform_parser =
+        parse::sequence<parse::choice<parse::literal<'L'>, parse::literal<'R'>>,
+                        parse::digits>;
+
+    static constexpr auto
+    is_valid_transform( const std::string_view transform ) noexcept {
+        const auto captures{ parse::parse_full<transform_parser>( transform ) };
+        if ( !captures )
+            return Transform{ false, false, 0 };
+
+        const auto & [direction, digits]{ *captures };
+        const auto size{ parse::to_number<std::uint32_t>( digits ) };
+        if ( !size )
+            return Transform{ false, false, 0 };
+
+        return Transform{ true, direction == 'R', *size };
+    };
+
+    constexpr auto passes_zero( const auto & transform ) {
+        return transform.size
+               >= ( transform.direction ? Size - m_position : m_position );
+    }
+
+    constexpr std::uint32_t zero_passes( const auto & transform ) {
+        if ( !passes_zero( transform ) )
+            return 0;
+
+        const std::uint32_t divisor{ revolutions( transform.size ) };
+        const std::uint32_t remainder{ wrap( transform.size ) };
+        const std::uint32_t passes{
+            divisor
+            + passes_zero( Transform(
+                transform.is_valid, transform.direction, remainder ) )
+            - ( m_position == 0 && !transform.direction )
+        };
+        return passes;
+    }
+
+    public:
+    constexpr Dial() = default;
+    constexpr ~Dial() = default;
+    constexpr Dial( const Dial & ) = default;
+    constexpr Dial( Dial && ) noexcept = default;
+    constexpr Dial & operator=( const Dial & ) = default;
+    constexpr Dial & operator=( Dial && ) noexcept = default;
+
+    constexpr auto transform( const std::string_view raw_transform ) noexcept {
+        [[maybe_unused]] const auto parse_start{ instrument_now() };
+        auto transform = is_valid_transform( raw_transform );
+        [[maybe_unused]] const auto apply_start{ instrument_now() };
+        record( [&]( auto & stats ) {
+            stats.parse_time += instrument_elapsed( parse_start );
+            stats.parse_failures += !transform.is_valid;
+        } );
+
+        if ( transform.is_valid ) {
+            const auto passes{ zero_passes( transform ) };
+            m_passes_zero_count += passes;
+
+            m_position +=
+                ( transform.direction ? wrap( transform.size ) :
+                                        Size - wrap( transform.size ) );
+            m_position = wrap( m_position );
+
+            if ( m_position == 0 )
+                m_zero_count++;
+
+            record( [&]( auto & stats ) {
+                stats.zero_passing_moves += passes > 0;
+                stats.multi_revolution_moves += transform.size >= Size;
+                stats.zero_landings += m_position == 0;
+            } );
+        }
+
+        record( [&]( auto & stats ) {
+            stats.apply_time += instrument_elapsed( apply_start );
+        } );
+        return m_position;
+    }
+
+    // Rotation equivalent of a raw transform, nullopt if it is not valid
+    static constexpr std::optional<Rotation>
+    parse_rotation( const std::string_view raw_transform ) noexcept {
+        const auto transform{ is_valid_transform( raw_transform ) };
+        if ( !transform.is_valid )
+            return std::nullopt;
+
+        const std::int64_t size{ transform.size };
+        return Rotation{ transform.direction ? size : -size };
+    }
+
+    /*
+     * Applies a batch of rotations, with the same counts as transforming
+     * one raw transform at a time.
+     *  - Within a block, S_0 is the position and S_i = S_(i-1) + delta_i,
+     *    without wrapping. Rotation i lands on zero when S_i mod Size == 0.
+     *  - Going right it passes zero floor(S_i / Size) - floor(S_(i-1) / Size)
+     *    times. Going left the same holds for S - 1 with the sign flipped,
+     *    as leaving zero is not a pass but arriving at it is, and
+     *    floor((S - 1) / Size) is floor(S / Size) less one when S lands on
+     *    zero.
+     *  - A bias keeps every S of a block positive, so each rotation costs
+     *    one unsigned division by a constant. The prefix sum is the only
+     *    loop-carried step, the counts are independent per rotation and
+     *    free of branches.
+     */
+    constexpr auto transform( const std::span<const Rotation> rotations ) noexcept {
+        constexpr std::size_t block_size{ 512 };
+        // Multiple of Size above the largest |S| of a block
+        constexpr std::uint64_t bias{ multiple_above( block_size << 32 ) };
+
+        [[maybe_unused]] const auto apply_start{ instrument_now() };
+        std::array<std::uint64_t, block_size + 1> sums{};
+        std::array<std::uint64_t, block_size + 1> turns{};
+        std::array<std::uint64_t, block_size + 1> landed{};
+        for ( std::size_t offset{ 0 }; offset < rotations.size();
+              offset += block_size ) {
+            const auto block{ rotations.subspan(
+                offset, std::min( block_size, rotations.size() - offset ) ) };
+
+            sums[0] = bias + m_position;
+            for ( std::size_t i{ 0 }; i < block.size(); ++i ) {
+                sums[i + 1] =
+                    sums[i] + static_cast<std::uint64_t>( block[i].delta );
+            }
+
+            for ( std::size_t i{ 0 }; i <= block.size(); ++i ) {
+                turns[i] = revolutions( sums[i] );
+                landed[i] = sums[i] == turns[i] * Size;
+            }
+
+            std::uint64_t passes{ 0 };
+            std::uint64_t landings{ 0 };
+            for ( std::size_t i{ 0 }; i < block.size(); ++i ) {
+                const std::uint64_t left{ block[i].delta < 0 };
+                const auto          right_passes{ turns[i + 1] - turns[i] };
+                const auto          left_passes{ ( turns[i] - landed[i] )
+                                        - ( turns[i + 1] - landed[i + 1] ) };
+                passes += left ? left_passes : right_passes;
+                landings += landed[i + 1];
+
+                record( [&]( auto & stats ) {
+                    stats.zero_passing_moves +=
+                        ( left ? left_passes : right_passes ) > 0;
+                    stats.multi_revolution_moves +=
+                        is_multi_revolution( block[i] );
+                } );
+            }
+            record( [&]( auto & stats ) { stats.zero_landings += landings; } );
+
+            m_passes_zero_count += static_cast<std::uint32_t>( passes );
+            m_zero_count += static_cast<std::uint32_t>( landings );
+            m_position = static_cast<std::uint32_t>( wrap( sums[block.size()] ) );
+        }
+
+        record( [&]( auto & stats ) {
+            stats.apply_time += instrument_elapsed( apply_start );
+        } );
+        return m_position;
+    }
+
+    /*
+     * Zero landings and passes of a run of rotations, as a function of the
+     * position the run starts from.
+     *  - With T_i the unwrapped sum of the first i deltas, starting from p
+     *    the run is at p + T_i. Rotation i lands on zero for the one p
+     *    where p + T_i is a multiple of Size, so landings is a histogram.
+     *  - Its passes are a difference of floor((p + a) / Size) for the a and
+     *    b given by transform(span). Writing a = Size * q + r, that is
+     *    q plus 1 once p >= Size - r: a constant and a step in p. The steps
+     *    go in a difference array, one prefix sum turns it into passes.
+     */
+    struct RunSummary
+    {
+        std::uint32_t                  shift;
+        std::array<std::uint64_t, Size> landings;
+        std::array<std::uint64_t, Size> passes;
+    };
+
+    // Longest run summarise takes
+    static constexpr std::size_t max_run{ std::size_t{ 1 } << 30 };
+
+    static constexpr RunSummary
+    summarise( const std::span<const Rotation> rotations ) noexcept {
+        assert( rotations.size() <= max_run );
+        // Multiple of Size above the largest |T| of a run, without
+        // overflowing above the largest T
+        constexpr std::uint64_t bias{ multiple_above( std::uint64_t{ max_run }
+                                                      << 32 ) };
+        static_assert( bias <= UINT64_MAX - ( std::uint64_t{ max_run } << 32 ) );
+
+        struct Split
+        {
+            std::uint64_t quotient;
+            std::uint32_t remainder;
+        };
+        const auto split = []( const std::uint64_t value ) {
+            return Split{ revolutions( value ),
+                          static_cast<std::uint32_t>( wrap( value ) ) };
+        };
+        // Split of value - 1 from the split of value
+        const auto less_one = []( const Split value ) {
+            return value.remainder > 0 ?
+                       Split{ value.quotient, value.remainder - 1 } :
+                       Split{ value.quotient - 1, Size - 1 };
+        };
+
+        RunSummary                    summary{};
+        std::array<std::int64_t, Size> steps{};
+        std::int64_t                  base{ 0 };
+        // Step up for p >= Size - remainder, never for a remainder of 0
+        const auto step = [&]( const std::uint32_t remainder,
+                               const std::int64_t  sign ) {
+            steps[wrap( Size - remainder )] += remainder > 0 ? sign : 0;
+        };
+
+        std::uint64_t sum{ bias };
+        auto          previous{ split( sum ) };
+        for ( const auto rotation : rotations ) {
+            sum += static_cast<std::uint64_t>( rotation.delta );
+            const auto current{ split( sum ) };
+
+            const auto left{ rotation.delta < 0 };
+            const auto high{ left ? less_one( previous ) : current };
+            const auto low{ left ? less_one( current ) : previous };
+            base += static_cast<std::int64_t>( high.quotient - low.quotient );
+            step( high.remainder, 1 );
+            step( low.remainder, -1 );
+
+            ++summary.landings[wrap( Size - current.remainder )];
+            previous = current;
+        }
+
+        std::int64_t passes{ base };
+        for ( std::size_t p{ 0 }; p < Size; ++p ) {
+            passes += steps[p];
+            summary.passes[p] = static_cast<std::uint64_t>( passes );
+        }
+        summary.shift = previous.remainder;
+        return summary;
+    }
+
+    // Same counts as transform(span) with the run summarised up front
+    constexpr auto apply( const RunSummary & summary ) noexcept {
+        record( [&]( auto & stats ) {
+            stats.zero_landings += summary.landings[m_position];
+        } );
+        m_zero_count += static_cast<std::uint32_t>(
+            summary.landings[m_position] );
+        m_passes_zero_count += static_cast<std::uint32_t>(
+            summary.passes[m_position] );
+        m_position = wrap( m_position + summary.shift );
+        return m_position;
+    }
+
+    /*
+     * Same counts as transform(span), with the rotations split into runs of
+     * chunk_size that are summarised in parallel on pool. Walking the
+     * summaries from the current position is one lookup per run, so only
+     * the summaries need the threads.
+     */
+    auto transform( const std::span<const Rotation> rotations,
+                    ThreadPool & pool, const std::size_t chunk_size = 1 << 20 ) {
+        assert( chunk_size > 0 && chunk_size <= max_run );
+
+        const auto n_chunks{ ( rotations.size() + chunk_size - 1 )
+                             / chunk_size };
+        std::vector<RunSummary>              summaries( n_chunks );
+        std::vector<Instrumented<DialStats>> chunk_stats(
+            instrumented ? n_chunks : 0 );
+        pool.parallel_for( n_chunks, [&]( const std::size_t i ) {
+            [[maybe_unused]] const auto apply_start{ instrument_now() };
+            const auto                  first{ i * chunk_size };
+            const auto                  chunk{ rotations.subspan(
+                first, std::min( chunk_size, rotations.size() - first ) ) };
+            summaries[i] = summarise( chunk );
+
+            instrument( chunk_stats, [&]( auto & all_stats ) {
+                auto & stats{ all_stats[i] };
+                stats.multi_revolution_moves +=
+                    static_cast<std::uint64_t>( std::ranges::count_if(
+                        chunk, is_multi_revolution ) );
+                stats.apply_time += instrument_elapsed( apply_start );
+            } );
+        } );
+
+        for ( const auto & summary : summaries ) { apply( summary ); }
+        record( [&]( auto & stats ) {
+            for ( const auto & chunk : chunk_stats ) { stats += chunk; }
+            stats.zero_passing_counted = false;
+        } );
+        return m_position;
+    }
+
+    template <record_range R>
+    constexpr auto transform( R && raw_transforms ) {
+        for ( const std::string_view raw_transform : raw_transforms ) {
+            transform( raw_transform );
+        }
+        return m_position;
+    }
+    template <record_range R>
+    constexpr explicit Dial( R && raw_transforms ) {
+        [[maybe_unused]] const auto position{ transform(
+            std::forward<R>( raw_transforms ) ) };
+    }
+
+    /*
+     * Parses and summarises the raw transforms of input, one per line, on
+     * pool. The input is cut at the line break after every chunk_bytes, and
+     * each chunk is split and parsed by the thread that summarises it.
+     * Invalid transforms are skipped as in the serial constructor.
+     */
+    Dial( const std::string_view input, ThreadPool & pool,
+          const std::size_t chunk_bytes = 1 << 22 ) {
+        assert( chunk_bytes > 0 && chunk_bytes < max_run );
+
+        const auto n_chunks{ ( input.size() + chunk_bytes - 1 )
+                             / chunk_bytes };
+        // Start of chunk i, just after the line break that ends chunk i - 1
+        const auto chunk_start = [&]( const std::size_t i ) {
+            if ( i == 0 )
+                return std::size_t{ 0 };
+            if ( i >= n_chunks )
+                return input.size();
+            const auto line_break{ input.find( '\n', i * chunk_bytes - 1 ) };
+            return line_break == std::string_view::npos ? input.size() :
+                                                          line_break + 1;
+        };
+
+        std::vector<RunSummary>              summaries( n_chunks );
+        std::vector<Instrumented<DialStats>> chunk_stats(
+            instrumented ? n_chunks : 0 );
+        pool.parallel_for( n_chunks, [&]( const std::size_t i ) {
+            [[maybe_unused]] const auto parse_start{ instrument_now() };
+            const auto                  first{ chunk_start( i ) };
+            const auto                  last{ chunk_start( i + 1 ) };
+            auto lines{ split_delimited( input.substr( first, last - first ),
+                                         '\n' ) };
+            // The empty piece after the line break ending the chunk is not
+            // a record, only the one after a line break ending the input is.
+            // Chunks within a long line are empty.
+            if ( first < last && last < input.size() )
+                lines.pop_back();
+
+            std::vector<Rotation> rotations{};
+            rotations.reserve( lines.size() );
+            for ( const auto raw_transform : lines ) {
+                if ( const auto rotation{ parse_rotation( raw_transform ) } )
+                    rotations.push_back( *rotation );
+            }
+
+            [[maybe_unused]] const auto parse_time{ instrument_elapsed(
+                parse_start ) };
+            [[maybe_unused]] const auto apply_start{ instrument_now() };
+            summaries[i] = summarise( rotations );
+
+            instrument( chunk_stats, [&]( auto & all_stats ) {
+                auto & stats{ all_stats[i] };
+                stats.parse_time += parse_time;
+                stats.parse_failures += lines.size() - rotations.size();
+                stats.multi_revolution_moves +=
+                    static_cast<std::uint64_t>( std::ranges::count_if(
+                        rotations, is_multi_revolution ) );
+                stats.apply_time += instrument_elapsed( apply_start );
+            } );
+        } );
+
+        for ( const auto & summary : summaries ) { apply( summary ); }
+        record( [&]( auto & stats ) {
+            for ( const auto & chunk : chunk_stats ) { stats += chunk; }
+            stats.zero_passing_counted = false;
+        } );
+    }
+
+    constexpr auto is_zero() const noexcept { return m_position == 0; }
+    constexpr auto zero_count() const noexcept { return m_zero_count; }
+    constexpr auto passes_zero_count() const noexcept {
+        return m_passes_zero_count;
+    }
+    constexpr auto position() const noexcept { return m_position; }
+    // Empty unless built with AOC_INSTRUMENT
+    constexpr const auto & stats() const noexcept { return m_stats; }
+    constexpr void reset() noexcept {
+        m_position = Start;
+        m_zero_count = 0;
+        m_passes_zero_count = 0;
+        m_stats = {};
+    }
+
+    constexpr void position( const std::uint32_t position ) {
+        m_position = position;
+    }
+    constexpr void zero_count( const std::uint32_t zero_count ) {
+        m_zero_count = zero_count;
+    }
+    constexpr void passes_zero_count( const std::uint32_t passes_zero_count ) {
+        m_passes_zero_count = passes_zero_count;
+    }
+};
@@ -0,0 +1,16 @@
+#include "rotation_generator.hpp"
+
+/*
+ * Usage: day1_generate [--count=N] [--max_size=N] [--seed=N]
+ *                      [--output=path]
+ */
+int
+main( const int argc, char ** argv ) {
+    const GeneratorArgs args{ argc, argv };
+    return args.run( [&args]( std::ostream & out ) {
+        generate_rotations( out,
+                            args.get( "count", 1'000'000 ),
+                            args.get( "max_size", 999 ),
+                            args.seed() );
+    } );
+}
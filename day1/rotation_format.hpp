@@ -0,0 +1,292 @@
+#pragma once
+
+#include "dial.hpp"
+#include "files.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/*
+ * Binary day 1 input: rotations parsed once, stored as signed deltas.
+ * Layout, all integers little endian:
+ *  - 16 byte header: the magic "AOCR", the format version (u16), the
+ *    payload encoding (u8), a reserved zero byte and the rotation count
+ *    (u64).
+ *  - Payload, by encoding:
+ *     - Int16: one i16 per rotation, for inputs whose sizes all fit.
+ *     - Varint: one zigzag LEB128 value per rotation (7 bits a byte, low
+ *       bits first), 1 byte for sizes below 64 and at most 5 for any size
+ *       up to UINT32_MAX.
+ *  - Readers decode the payload in blocks straight out of the mapped file
+ *    into Rotations, ready for Dial::transform.
+ */
+
+enum class RotationEncoding : std::uint8_t { Int16 = 0, Varint = 1 };
+
+struct RotationHeader
+{
+    static constexpr std::array<char, 4> magic{ 'A', 'O', 'C', 'R' };
+    static constexpr std::uint16_t       current_version{ 1 };
+    static constexpr std::size_t         size{ 16 };
+
+    std::uint16_t    version{ current_version };
+    RotationEncoding encoding{ RotationEncoding::Int16 };
+    std::uint64_t    count{ 0 };
+};
+
+namespace detail
+{
+
+template <std::unsigned_integral T>
+constexpr T
+to_little_endian( const T value ) noexcept {
+    if constexpr ( std::endian::native == std::endian::big )
+        return std::byteswap( value );
+    else
+        return value;
+}
+
+template <std::unsigned_integral T>
+void
+write_little_endian( std::ostream & out, const T value ) {
+    const auto little{ to_little_endian( value ) };
+    out.write( reinterpret_cast<const char *>( &little ), sizeof( little ) );
+}
+
+template <std::unsigned_integral T>
+T
+read_little_endian( const char * data ) noexcept {
+    T value;
+    std::memcpy( &value, data, sizeof( value ) );
+    return to_little_endian( value );
+}
+
+constexpr std::uint64_t
+zigzag( const std::int64_t value ) noexcept {
+    return ( static_cast<std::uint64_t>( value ) << 1 )
+           ^ static_cast<std::uint64_t>( value >> 63 );
+}
+
+constexpr std::int64_t
+unzigzag( const std::uint64_t value ) noexcept {
+    return static_cast<std::int64_t>( ( value >> 1 )
+                                      ^ ( 0ULL - ( value & 1 ) ) );
+}
+
+// Largest zigzag value of a rotation, that of R<UINT32_MAX>
+constexpr std::uint64_t max_zigzag{ zigzag( std::int64_t{ UINT32_MAX } ) };
+
+} // namespace detail
+
+// Whether every rotation fits the Int16 encoding
+[[nodiscard]] constexpr bool
+fits_int16( const std::span<const Rotation> rotations ) noexcept {
+    return std::ranges::all_of( rotations, []( const Rotation rotation ) {
+        return rotation.delta >= INT16_MIN && rotation.delta <= INT16_MAX;
+    } );
+}
+
+// Writes the header and payload, rotations must fit the encoding
+inline void
+write_rotations( std::ostream & out, const std::span<const Rotation> rotations,
+                 const RotationEncoding encoding ) {
+    assert( encoding != RotationEncoding::Int16 || fits_int16( rotations ) );
+
+    out.write( RotationHeader::magic.data(), RotationHeader::magic.size() );
+    detail::write_little_endian( out, RotationHeader::current_version );
+    detail::write_little_endian( out, static_cast<std::uint8_t>( encoding ) );
+    detail::write_little_endian( out, std::uint8_t{ 0 } );
+    detail::write_little_endian( out, std::uint64_t{ rotations.size() } );
+
+    // Encoded a chunk at a time so the stream sees few large writes
+    std::vector<char> chunk{};
+    chunk.reserve( 1 << 16 );
+    const auto flush = [&] {
+        out.write( chunk.data(), static_cast<std::streamsize>( chunk.size() ) );
+        chunk.clear();
+    };
+
+    for ( const auto rotation : rotations ) {
+        if ( encoding == RotationEncoding::Int16 ) {
+            const auto value{ detail::to_little_endian(
+                static_cast<std::uint16_t>( rotation.delta ) ) };
+            std::array<char, sizeof( value )> bytes;
+            std::memcpy( bytes.data(), &value, sizeof( value ) );
+            chunk.insert( chunk.end(), bytes.begin(), bytes.end() );
+        } else {
+            auto value{ detail::zigzag( rotation.delta ) };
+            while ( value >= 0x80 ) {
+                chunk.push_back( static_cast<char>( ( value & 0x7f ) | 0x80 ) );
+                value >>= 7;
+            }
+            chunk.push_back( static_cast<char>( value ) );
+        }
+
+        if ( chunk.size() >= ( 1 << 16 ) - 8 )
+            flush();
+    }
+    flush();
+}
+
+/*
+ * Rotations encoded in a byte buffer, e.g. a mapped file.
+ *  - The header is checked on construction. A buffer that is not a
+ *    rotation file, has an unknown version or encoding, or is too short
+ *    for its count leaves the view invalid, with the reason on stderr.
+ *  - Varint payloads can only be checked while decoding, for_each_block
+ *    stops and returns false at the first malformed value.
+ */
+class RotationView
+{
+    private:
+    RotationHeader   m_header{};
+    std::string_view m_payload{};
+    bool             m_is_valid{ false };
+
+    [[nodiscard]] static bool fail( const std::string_view reason ) {
+        std::cerr << std::format( "Invalid rotation file: {}.", reason )
+                  << std::endl;
+        return false;
+    }
+
+    bool read_header( const std::string_view bytes ) {
+        if ( bytes.size() < RotationHeader::size
+             || !std::ranges::equal( bytes.substr( 0, 4 ),
+                                     RotationHeader::magic ) )
+            return fail( "missing header" );
+
+        m_header.version = detail::read_little_endian<std::uint16_t>(
+            bytes.data() + 4 );
+        if ( m_header.version != RotationHeader::current_version )
+            return fail( std::format( "unknown version {}", m_header.version ) );
+
+        const auto encoding{ static_cast<std::uint8_t>( bytes[6] ) };
+        if ( encoding > static_cast<std::uint8_t>( RotationEncoding::Varint ) )
+            return fail( std::format( "unknown encoding {}", encoding ) );
+        m_header.encoding = static_cast<RotationEncoding>( encoding );
+
+        m_header.count = detail::read_little_endian<std::uint64_t>(
+            bytes.data() + 8 );
+        m_payload = bytes.substr( RotationHeader::size );
+
+        // Every encoded rotation takes at least a byte, Int16 exactly two
+        const auto min_payload{ m_header.encoding == RotationEncoding::Int16 ?
+                                    m_header.count * 2 :
+                                    m_header.count };
+        if ( m_header.count > m_payload.size() || m_payload.size() < min_payload )
+            return fail( "payload shorter than its rotation count" );
+        return true;
+    }
+
+    public:
+    static constexpr std::size_t block_size{ 1 << 14 };
+
+    RotationView() = default;
+    explicit RotationView( const std::string_view bytes ) :
+        m_is_valid( read_header( bytes ) ) {}
+
+    [[nodiscard]] bool is_valid() const noexcept { return m_is_valid; }
+    [[nodiscard]] const RotationHeader & header() const noexcept {
+        return m_header;
+    }
+    [[nodiscard]] std::uint64_t size() const noexcept {
+        return m_is_valid ? m_header.count : 0;
+    }
+
+    /*
+     * Calls function( std::span<const Rotation> ) on consecutive blocks of
+     * up to block_size rotations, in order. Returns whether the whole
+     * payload decoded.
+     */
+    template <typename F>
+    bool for_each_block( F && function ) const {
+        if ( !m_is_valid )
+            return false;
+
+        std::vector<Rotation> block( block_size );
+        const auto *          data{ m_payload.data() };
+        const auto * const    end{ m_payload.data() + m_payload.size() };
+
+        for ( std::uint64_t done{ 0 }; done < m_header.count; ) {
+            const auto n{ static_cast<std::size_t>(
+                std::min<std::uint64_t>( block_size, m_header.count - done ) ) };
+
+            if ( m_header.encoding == RotationEncoding::Int16 ) {
+                for ( std::size_t i{ 0 }; i < n; ++i, data += 2 ) {
+                    block[i].delta = static_cast<std::int16_t>(
+                        detail::read_little_endian<std::uint16_t>( data ) );
+                }
+            } else {
+                for ( std::size_t i{ 0 }; i < n; ++i ) {
+                    std::uint64_t value{ 0 };
+                    std::uint32_t shift{ 0 };
+                    while ( true ) {
+                        if ( data == end )
+                            return fail( "truncated varint" );
+                        const auto byte{ static_cast<std::uint8_t>( *data++ ) };
+                        // The fifth byte holds the top bits and ends it
+                        if ( shift == 28 && byte > 0x7f )
+                            return fail( "varint longer than 5 bytes" );
+                        value |= static_cast<std::uint64_t>( byte & 0x7f )
+                                 << shift;
+                        if ( ( byte & 0x80 ) == 0 )
+                            break;
+                        shift += 7;
+                    }
+                    if ( value > detail::max_zigzag )
+                        return fail( "rotation size above UINT32_MAX" );
+                    block[i].delta = detail::unzigzag( value );
+                }
+            }
+
+            function( std::span<const Rotation>{ block.data(), n } );
+            done += n;
+        }
+        return true;
+    }
+
+    // Applies every rotation to dial, returns whether the payload decoded
+    template <std::uint32_t Size, std::uint32_t Start>
+    bool transform( Dial<Size, Start> & dial ) const {
+        return for_each_block( [&dial]( const std::span<const Rotation> block ) {
+            [[maybe_unused]] const auto position{ dial.transform( block ) };
+        } );
+    }
+};
+
+// Rotation file mapped from disk, see InputFile
+class RotationFile
+{
+    private:
+    InputFile    m_file;
+    RotationView m_rotations;
+
+    public:
+    RotationFile() = delete;
+    explicit RotationFile( const std::filesystem::path & path ) :
+        m_file( path ), m_rotations( m_file.view() ) {}
+
+    RotationFile( const RotationFile & ) = delete;
+    RotationFile( RotationFile && ) = delete;
+    RotationFile & operator=( const RotationFile & ) = delete;
+    RotationFile & operator=( RotationFile && ) = delete;
+
+    ~RotationFile() = default;
+
+    [[nodiscard]] const RotationView & rotations() const noexcept {
+        return m_rotations;
+    }
+};
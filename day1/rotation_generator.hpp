@@ -0,0 +1,35 @@
+#pragma once
+
+#include "generator.hpp"
+
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <ostream>
+#include <random>
+#include <string>
+
+/*
+ * Synthetic day 1 input: count lines of L<n>/R<n> rotations, with
+ * n uniform in [1, max_size]. The real input has 4,485 rotations with
+ * sizes up to 999.
+ */
+inline void
+generate_rotations( std::ostream & out, const std::uint64_t count,
+                    const std::uint64_t max_size, const std::uint64_t seed ) {
+    std::mt19937_64 rng{ seed };
+
+    std::string chunk{};
+    for ( std::uint64_t i{ 0 }; i < count; ++i ) {
+        const char direction{ ( rng() & 1 ) != 0 ? 'R' : 'L' };
+        std::format_to( std::back_inserter( chunk ),
+                        "{}{}\n",
+                        direction,
+                        uniform_between( rng, 1, max_size ) );
+        if ( chunk.size() >= ( 1 << 16 ) ) {
+            out << chunk;
+            chunk.clear();
+        }
+    }
+    out << chunk;
+}
@@ -1,268 +1,196 @@
 #include "constants.hpp"
 #include "files.hpp"
+#include "range.hpp"
+#include "thread_pool.hpp"
 
 #include <algorithm>
-#include <cassert>
-#include <cmath>
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <numeric>
+#include <ranges>
+#include <string_view>
+#include <vector>
 
-enum class Question { One, Two };
+#ifdef AOC_CONSTEVAL
+#include "embedded_input.hpp"
+#endif
 
-template <Question Q>
-class Range
-{
-    private:
-    std::uint64_t m_first;
-    std::uint64_t m_last;
-    bool          m_valid_range;
-
-    static constexpr auto num_digits( std::uint64_t id ) {
-        std::uint64_t digits{ 0 };
-        while ( id != 0 ) {
-            digits++;
-            id /= 10;
-        }
-        return digits;
-    }
-
-    static constexpr auto id_subrange( const std::uint64_t id,
-                                       const std::uint64_t left,
-                                       const std::uint64_t right ) {
-        const auto n_digits{ num_digits( id ) };
-
-        assert( left <= right );
-        assert( right <= n_digits );
-
-        const auto right_shift_divisor{ static_cast<std::uint64_t>(
-            std::pow( 10, n_digits - right ) ) };
-        const auto shifted_remainder{ static_cast<std::uint64_t>(
-            std::pow( 10, right - left ) ) };
-
-        // Remove rightmost unnecessary digits
-        const auto shifted_id{ id / right_shift_divisor };
-
-        // Retrieve desired digits
-        return shifted_id % shifted_remainder;
-    }
-
-    static constexpr auto id_chunks( const std::uint64_t id,
-                                     const std::uint64_t chunk_size ) {
-        const auto n_digits{ num_digits( id ) };
-        assert( n_digits % chunk_size == 0 );
-
-        std::vector<std::uint64_t> chunks( n_digits / chunk_size );
-
-        for ( std::uint64_t i{ 0 }; i < n_digits / chunk_size; i++ ) {
-            chunks[i] =
-                id_subrange( id, i * chunk_size, ( i + 1 ) * chunk_size );
-        }
-
-        return chunks;
-    }
-
-    static constexpr auto valid_id( const std::uint64_t id )
-        requires( Q == Question::One )
-    {
-        const auto n_digits{ num_digits( id ) };
-        if ( n_digits % 2 != 0 )
-            return true;
-
-        constexpr auto first_half_digits = []( const auto id,
-                                               const auto n_digits ) {
-            return id
-                   / static_cast<std::uint64_t>( std::pow( 10, n_digits / 2 ) );
-        };
-        constexpr auto last_half_digits = []( const auto id,
-                                              const auto n_digits ) {
-            return id
-                   % static_cast<std::uint64_t>( std::pow( 10, n_digits / 2 ) );
-        };
-
-        const auto first_half{ first_half_digits( id, n_digits ) };
-        const auto last_half{ last_half_digits( id, n_digits ) };
+enum class Evaluation { ClosedForm, Parallel };
 
-        return first_half != last_half;
-    }
-
-    static constexpr auto valid_id( const std::uint64_t id )
-        requires( Q == Question::Two )
-    {
-        const auto n_digits{ num_digits( id ) };
-
-        // Determine valid divisors
-        const auto divisors{ std::ranges::iota_view( std::uint64_t{ 2 },
-                                                     n_digits + 1 )
-                             | std::views::filter( [&n_digits]( const auto n ) {
-                                   return n_digits % n == 0;
-                               } )
-                             | std::ranges::to<std::vector<std::uint64_t>>() };
-
-        // Check all chunks of divisor size for matching patterns
-        for ( const auto divisor : divisors ) {
-            const auto chunks{ id_chunks( id, n_digits / divisor ) };
-
-            const auto invalid_id{ ( chunks | std::views::slide( 2 )
-                                     | std::views::drop_while(
-                                         []( const auto & window ) {
-                                             return window[0] == window[1];
-                                         } ) )
-                                       .empty() };
-
-            if ( invalid_id )
-                return false;
-        }
-
-        return true;
-    }
-
-    public:
-    Range() = delete;
-    constexpr Range( const std::uint64_t first, const std::uint64_t last ) :
-        m_first( first ), m_last( last ), m_valid_range( m_first < m_last ) {}
-    Range( const std::string_view range ) {
-        const std::regex pattern{ "([0-9]+)-([0-9]+)" };
-        std::smatch      results;
-
-        const std::string tmp{ range.data(), range.size() };
-        m_valid_range =
-            std::regex_match( tmp.cbegin(), tmp.cend(), results, pattern );
+// Sum of every range's closed form, constructing ranges one at a time so
+// inputs may be streamed
+template <Question Q>
+constexpr std::uint64_t
+closed_form_invalid_id_sum( record_range auto && inputs ) {
+    return std::ranges::fold_left(
+        inputs | std::views::transform( []( const std::string_view rng ) {
+            return Range<Q>{ rng }.invalid_id_sum();
+        } ),
+        std::uint64_t{ 0 },
+        std::plus{} );
+}
 
-        if ( m_valid_range ) {
-            m_first = static_cast<std::uint64_t>( std::stoul( results[1] ) );
-            m_last = static_cast<std::uint64_t>( std::stoul( results[2] ) );
-            m_valid_range &= m_first < m_last;
-        }
+template <Question Q>
+std::uint64_t
+total_invalid_id_sum( record_range auto && inputs,
+                      const Evaluation     evaluation ) {
+    if ( evaluation == Evaluation::Parallel ) {
+        ThreadPool pool{};
+        return parallel_invalid_id_sum(
+            inputs | std::views::transform( []( const std::string_view rng ) {
+                return Range<Q>{ rng };
+            } ) | std::ranges::to<std::vector<Range<Q>>>(),
+            pool );
     }
 
-    constexpr Range( const Range & ) = default;
-    constexpr Range( Range && ) noexcept = default;
-
-    constexpr Range & operator=( const Range & ) = default;
-    constexpr Range & operator=( Range && ) noexcept = default;
-
-    ~Range() = default;
-
-    constexpr auto first() const noexcept { return m_first; }
-    constexpr auto last() const noexcept { return m_last; }
-
-    constexpr auto is_valid() const noexcept { return m_valid_range; }
-
-    constexpr auto ids() const noexcept {
-        if ( !m_valid_range ) {
-            return std::vector<std::uint64_t>{};
-        }
-
-        return std::ranges::iota_view{ m_first, m_last + 1 }
-               | std::ranges::to<std::vector<std::uint64_t>>();
-    }
-    constexpr auto valid_ids() const noexcept {
-        if ( !m_valid_range ) {
-            return std::vector<std::uint64_t>{};
-        }
+    return closed_form_invalid_id_sum<Q>( inputs );
+}
 
-        if constexpr ( Q == Question::One ) {
-            // Early escape without filtering
-            const auto n_digits_first{ num_digits( m_first ) };
-            const auto n_digits_last{ num_digits( m_last ) };
-            if ( n_digits_first == n_digits_last && n_digits_first % 2 != 0 ) {
-                return std::ranges::iota_view{ m_first, m_last + 1 }
-                       | std::ranges::to<std::vector<std::uint64_t>>();
-            }
-        }
+constexpr auto
+problem_1( record_range auto && inputs, const Evaluation evaluation ) {
+    std::println( "Problem One | Sum: {}",
+                  total_invalid_id_sum<Question::One>( inputs, evaluation ) );
+}
 
-        // Filtering numbers
-        return std::ranges::iota_view{ m_first, m_last + 1 }
-               | std::views::filter( valid_id )
-               | std::ranges::to<std::vector<std::uint64_t>>();
-    }
-    constexpr auto invalid_ids() const noexcept {
-        if ( !m_valid_range ) {
-            return std::vector<std::uint64_t>{};
-        }
+constexpr auto
+problem_2( record_range auto && inputs, const Evaluation evaluation ) {
+    std::println( "Problem Two | Sum: {}",
+                  total_invalid_id_sum<Question::Two>( inputs, evaluation ) );
+}
 
-        return std::ranges::iota_view{ m_first, m_last + 1 }
-               | std::views::filter(
-                   []( const auto id ) { return !valid_id( id ); } )
-               | std::ranges::to<std::vector<std::uint64_t>>();
-    }
+static const std::vector<std::string_view> test_input{
+    "11-22",
+    "95-115",
+    "998-1012",
+    "1188511880-1188511890",
+    "222220-222224",
+    "1698522-1698528",
+    "446443-446449",
+    "38593856-38593862",
+    "565653-565659",
+    "824824821-824824827",
+    "2121212118-2121212124"
 };
 
+// Closed-form sums must match enumerating every ID
 template <Question Q>
-std::ostream &
-operator<<( std::ostream & os, const Range<Q> & rng ) {
-    const auto ids{ rng.ids() };
-
-    os << "Range{{ ";
-    if ( ids.size() < 31 ) {
-        for ( const auto id : ids ) { os << std::format( "{}, ", id ); }
-    }
-    else {
-        os << std::format( "{} - {} ",
-                           *std::min( ids.cbegin(), ids.cend() ),
-                           *std::max( ids.cbegin(), ids.cend() ) );
+bool
+verify_invalid_id_sum( const std::uint64_t expected_sum ) {
+    std::uint64_t closed_form_sum{ 0 };
+    std::uint64_t enumerated_sum{ 0 };
+    for ( const auto input : test_input ) {
+        const Range<Q> rng{ input };
+        const auto     invalid_ids{ rng.invalid_ids() };
+
+        closed_form_sum += rng.invalid_id_sum();
+        enumerated_sum += std::accumulate(
+            invalid_ids.cbegin(), invalid_ids.cend(), std::uint64_t{ 0 } );
     }
-    return os << "}}";
-}
-
-constexpr auto
-problem_1( const auto & inputs ) {
-    // Construct ranges
-    const auto ranges{ inputs | std::views::transform( []( const auto rng ) {
-                           return Range<Question::One>{ rng };
-                       } )
-                       | std::ranges::to<std::vector<Range<Question::One>>>() };
 
-    const auto sum{ std::accumulate(
-        ranges.cbegin(),
-        ranges.cend(),
-        std::uint64_t{ 0 },
-        []( auto sum, const auto & rng ) {
-            const auto & invalid_ids{ rng.invalid_ids() };
-            const auto sub_sum{ std::accumulate( invalid_ids.cbegin(),
-                                                 invalid_ids.cend(),
-                                                 std::uint64_t{ 0 } ) };
-            return sum += sub_sum;
-        } ) };
+    std::println( "closed form sum: {}, enumerated sum: {}, expected sum: {}",
+                  closed_form_sum,
+                  enumerated_sum,
+                  expected_sum );
 
-    std::println( "Problem One | Sum: {}", sum );
+    return closed_form_sum == expected_sum && enumerated_sum == expected_sum;
 }
 
-constexpr auto
-problem_2( const auto & inputs ) {
-    // Construct ranges
-    const auto ranges{ inputs | std::views::transform( []( const auto rng ) {
-                           return Range<Question::Two>{ rng };
-                       } )
-                       | std::ranges::to<std::vector<Range<Question::Two>>>() };
-
-    const auto sum{ std::accumulate(
-        ranges.cbegin(),
-        ranges.cend(),
-        std::uint64_t{ 0 },
-        []( auto sum, const auto & rng ) {
-            const auto & invalid_ids{ rng.invalid_ids() };
-            const auto sub_sum{ std::accumulate( invalid_ids.cbegin(),
-                                                 invalid_ids.cend(),
-                                                 std::uint64_t{ 0 } ) };
-            return sum += sub_sum;
-        } ) };
+// Enumerating on a pool must match the closed form, with chunks small
+// enough that every range is split across tasks
+template <Question Q>
+bool
+verify_parallel_invalid_id_sum() {
+    const auto ranges{ test_input
+                       | std::views::transform( []( const auto input ) {
+                             return Range<Q>{ input };
+                         } )
+                       | std::ranges::to<std::vector<Range<Q>>>() };
+
+    ThreadPool pool{ 4 };
+    const auto parallel_sum{ parallel_invalid_id_sum( ranges, pool, 3 ) };
+    const auto closed_form_sum{ closed_form_invalid_id_sum<Q>( test_input ) };
+
+    std::println( "parallel sum: {}, closed form sum: {}",
+                  parallel_sum,
+                  closed_form_sum );
+
+    return parallel_sum == closed_form_sum;
+}
 
-    std::println( "Problem Two | Sum: {}", sum );
+// A file ending in line breaks must not lose its last range
+constexpr bool
+verify_trailing_newline() {
+    const std::uint64_t expected_sum{ 11 + 22 + 99 };
+    return closed_form_invalid_id_sum<Question::One>(
+               split_input( "11-22,95-115\n", "," ) )
+               == expected_sum
+           && closed_form_invalid_id_sum<Question::One>(
+                  split_input( "11-22,95-115\r\n\n", "," ) )
+                  == expected_sum;
 }
 
+#ifdef AOC_CONSTEVAL
+// The closed form of problem_1 and problem_2, run over the embedded input by
+// the compiler
+template <Question Q>
+consteval std::uint64_t
+constant_invalid_id_sum() {
+    return closed_form_invalid_id_sum<Q>( split_input( embedded_input, "," ) );
+}
 
+static_assert( closed_form_invalid_id_sum<Question::One>(
+                   std::array<std::string_view, 2>{ "11-22", "95-115" } )
+               == 11 + 22 + 99 );
+static_assert( verify_trailing_newline() );
+#endif
 
+// Pass --parallel to enumerate every ID on all cores instead of using
+// the closed form
 int
-main() {
-    // Read data
-    const auto raw_input{ get_input_file( 2 ) };
-
-    // Split into text ranges
-    const auto inputs{ split_input( raw_input, "," ) };
+main( const int argc, char ** argv ) {
+#ifdef AOC_CONSTEVAL
+    // Everything was computed while compiling
+    std::println( "Problem One | Sum: {}",
+                  constant_invalid_id_sum<Question::One>() );
+    std::println( "Problem Two | Sum: {}",
+                  constant_invalid_id_sum<Question::Two>() );
+    return 0;
+#endif
+
+    const bool parallel{ argc > 1
+                         && std::string_view{ argv[1] } == "--parallel" };
+    const auto evaluation{ parallel ? Evaluation::Parallel :
+                                      Evaluation::ClosedForm };
+
+    if ( !verify_invalid_id_sum<Question::One>( 1227775554 ) ) {
+        std::println( "Question one summation errors." );
+        return 0;
+    }
+    if ( !verify_invalid_id_sum<Question::Two>( 4174379265 ) ) {
+        std::println( "Question two summation errors." );
+        return 0;
+    }
+    if ( !verify_parallel_invalid_id_sum<Question::One>()
+         || !verify_parallel_invalid_id_sum<Question::Two>() ) {
+        std::println( "Parallel summation errors." );
+        return 0;
+    }
+    if ( !verify_trailing_newline() ) {
+        std::println( "Trailing newline errors." );
+        return 0;
+    }
 
     // Problem 1
-    problem_1( inputs );
+    auto ranges_1{ stream_input_file( 2, ',' ) };
+    problem_1( ranges_1, evaluation );
 
     // Problem 2
-    problem_2( inputs );
+    auto ranges_2{ stream_input_file( 2, ',' ) };
+    problem_2( ranges_2, evaluation );
+
+    if ( ranges_1.failed() || ranges_2.failed() ) {
+        std::println( "Input was not read whole, the sums are partial." );
+        return 1;
+    }
 }
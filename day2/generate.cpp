@@ -0,0 +1,17 @@
+#include "range_generator.hpp"
+
+/*
+ * Usage: day2_generate [--count=N] [--max_digits=N] [--max_width=N]
+ *                      [--seed=N] [--output=path]
+ */
+int
+main( const int argc, char ** argv ) {
+    const GeneratorArgs args{ argc, argv };
+    return args.run( [&args]( std::ostream & out ) {
+        generate_ranges( out,
+                         args.get( "count", 1'000 ),
+                         args.get( "max_digits", 18 ),
+                         args.get( "max_width", 1'000'000 ),
+                         args.seed() );
+    } );
+}
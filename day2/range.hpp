@@ -0,0 +1,351 @@
+#pragma once
+
+#include "files.hpp"
+#include "numeric.hpp"
+#include "parse.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <ranges>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class Question { One, Two };
+
+template <Question Q>
+class Range
+{
+    private:
+    std::uint64_t m_first;
+    std::uint64_t m_last;
+    bool          m_valid_range;
+
+    // Equivalent to the regex ([0-9]+)-([0-9]+)
+    using range_parser =
+        parse::sequence<parse::digits, parse::literal<'-'>, parse::digits>;
+
+    static constexpr auto valid_id( const std::uint64_t id )
+        requires( Q == Question::One )
+    {
+        const auto n_digits{ num_digits( id ) };
+        if ( n_digits % 2 != 0 )
+            return true;
+
+        constexpr auto first_half_digits = []( const auto id,
+                                               const auto n_digits ) {
+            return id / pow10( n_digits / 2 );
+        };
+        constexpr auto last_half_digits = []( const auto id,
+                                              const auto n_digits ) {
+            return id % pow10( n_digits / 2 );
+        };
+
+        const auto first_half{ first_half_digits( id, n_digits ) };
+        const auto last_half{ last_half_digits( id, n_digits ) };
+
+        return first_half != last_half;
+    }
+
+    // Candidate pattern lengths for an n digit ID: n / q for each prime q
+    // dividing n. Any repeating pattern of length d also repeats with
+    // length n / q for some prime q dividing n / d, so these suffice.
+    struct PatternLengths
+    {
+        std::array<std::uint8_t, 4> lengths;
+        std::uint8_t                count;
+    };
+    static constexpr auto pattern_length_table{ [] {
+        std::array<PatternLengths, 21> table{};
+        for ( std::uint8_t n{ 2 }; n < table.size(); ++n ) {
+            std::uint8_t rest{ n };
+            for ( std::uint8_t q{ 2 }; q <= rest; ++q ) {
+                if ( rest % q != 0 )
+                    continue;
+                auto & entry{ table[n] };
+                entry.lengths[entry.count++] =
+                    static_cast<std::uint8_t>( n / q );
+                while ( rest % q == 0 ) { rest /= q; }
+            }
+        }
+        return table;
+    }() };
+
+    static constexpr auto valid_id( const std::uint64_t id )
+        requires( Q == Question::Two )
+    {
+        const auto n_digits{ num_digits( id ) };
+
+        // Decompose once, most significant digit first
+        std::array<std::uint8_t, 20> digits{};
+        auto                         rest{ id };
+        for ( auto i{ n_digits }; i > 0; --i ) {
+            digits[i - 1] = static_cast<std::uint8_t>( rest % 10 );
+            rest /= 10;
+        }
+
+        // Invalid if the digits repeat with any candidate pattern length
+        const auto & [lengths, count]{ pattern_length_table[n_digits] };
+        for ( std::uint8_t i{ 0 }; i < count; ++i ) {
+            const auto length{ lengths[i] };
+
+            bool repeats{ true };
+            for ( auto j{ length }; j < n_digits && repeats; ++j ) {
+                repeats = digits[j] == digits[j - length];
+            }
+            if ( repeats )
+                return false;
+        }
+
+        return true;
+    }
+
+    // Closed-form summation of invalid IDs.
+    //  - Every n digit ID made of a d digit pattern p repeated n / d times
+    //    is p * (10^n - 1) / (10^d - 1), so the invalid IDs in [lo, hi]
+    //    for one (n, d) pair are an arithmetic series over p.
+    //  - Question::One only has d = n / 2.
+    //  - Question::Two takes the union over d = n / q for every prime
+    //    q dividing n, with inclusion-exclusion removing IDs counted for
+    //    several q (periods n / q1 and n / q2 imply period n / (q1 q2)).
+    // Cost depends only on the number of digits in the range.
+
+    // Sum of n digit IDs in [lo, hi] with a repeating period of d digits
+    static constexpr uint128 periodic_id_sum( const uint128       lo,
+                                              const uint128       hi,
+                                              const std::uint64_t n,
+                                              const std::uint64_t d ) {
+        const auto repunit{ ( pow10_wide( n ) - 1 )
+                            / ( pow10_wide( d ) - 1 ) };
+        const auto first_pattern{ std::max( pow10_wide( d - 1 ),
+                                            ( lo + repunit - 1 ) / repunit ) };
+        const auto last_pattern{ std::min( pow10_wide( d ) - 1,
+                                           hi / repunit ) };
+        if ( first_pattern > last_pattern )
+            return 0;
+
+        const auto count{ last_pattern - first_pattern + 1 };
+        return repunit * ( ( first_pattern + last_pattern ) * count / 2 );
+    }
+
+    // Sum of invalid IDs in [lo, hi], all of which have n digits
+    static constexpr uint128 invalid_id_sum( const uint128       lo,
+                                             const uint128       hi,
+                                             const std::uint64_t n ) {
+        if constexpr ( Q == Question::One ) {
+            return n % 2 == 0 ? periodic_id_sum( lo, hi, n, n / 2 ) : 0;
+        }
+        else {
+            std::array<std::uint64_t, 4> primes{};
+            std::size_t                  n_primes{ 0 };
+            for ( std::uint64_t q{ 2 }, rest{ n }; q <= rest; ++q ) {
+                if ( rest % q != 0 )
+                    continue;
+                primes[n_primes++] = q;
+                while ( rest % q == 0 ) { rest /= q; }
+            }
+
+            uint128 added{ 0 };
+            uint128 removed{ 0 };
+            for ( std::uint64_t subset{ 1 }; subset < ( 1U << n_primes );
+                  ++subset ) {
+                std::uint64_t product{ 1 };
+                for ( std::size_t i{ 0 }; i < n_primes; ++i ) {
+                    if ( ( subset >> i ) & 1 )
+                        product *= primes[i];
+                }
+                const auto sum{ periodic_id_sum( lo, hi, n, n / product ) };
+                if ( std::popcount( subset ) % 2 == 1 )
+                    added += sum;
+                else
+                    removed += sum;
+            }
+            return added - removed;
+        }
+    }
+
+    public:
+    Range() = delete;
+    constexpr Range( const std::uint64_t first, const std::uint64_t last ) :
+        m_first( first ), m_last( last ), m_valid_range( m_first < m_last ) {}
+    constexpr Range( const std::string_view record ) :
+        m_first( 0 ), m_last( 0 ), m_valid_range( false ) {
+        // The last record of a file keeps the line breaks that end it
+        const auto range{ record.substr(
+            0, record.find_last_not_of( " \t\r\n" ) + 1 ) };
+        const auto captures{ parse::parse_full<range_parser>( range ) };
+        if ( !captures )
+            return;
+
+        const auto first{ parse::to_number<std::uint64_t>(
+            std::get<0>( *captures ) ) };
+        const auto last{ parse::to_number<std::uint64_t>(
+            std::get<2>( *captures ) ) };
+        if ( first && last ) {
+            m_first = *first;
+            m_last = *last;
+            m_valid_range = m_first < m_last;
+        }
+    }
+
+    constexpr Range( const Range & ) = default;
+    constexpr Range( Range && ) noexcept = default;
+
+    constexpr Range & operator=( const Range & ) = default;
+    constexpr Range & operator=( Range && ) noexcept = default;
+
+    ~Range() = default;
+
+    constexpr auto first() const noexcept { return m_first; }
+    constexpr auto last() const noexcept { return m_last; }
+
+    constexpr auto is_valid() const noexcept { return m_valid_range; }
+
+    constexpr auto ids() const noexcept {
+        if ( !m_valid_range ) {
+            return std::vector<std::uint64_t>{};
+        }
+
+        return std::ranges::iota_view{ m_first, m_last + 1 }
+               | std::ranges::to<std::vector<std::uint64_t>>();
+    }
+    constexpr auto valid_ids() const noexcept {
+        if ( !m_valid_range ) {
+            return std::vector<std::uint64_t>{};
+        }
+
+        if constexpr ( Q == Question::One ) {
+            // Early escape without filtering
+            const auto n_digits_first{ num_digits( m_first ) };
+            const auto n_digits_last{ num_digits( m_last ) };
+            if ( n_digits_first == n_digits_last && n_digits_first % 2 != 0 ) {
+                return std::ranges::iota_view{ m_first, m_last + 1 }
+                       | std::ranges::to<std::vector<std::uint64_t>>();
+            }
+        }
+
+        // Filtering numbers
+        return std::ranges::iota_view{ m_first, m_last + 1 }
+               | std::views::filter( valid_id )
+               | std::ranges::to<std::vector<std::uint64_t>>();
+    }
+    // Equal to summing invalid_ids(), without enumerating the range
+    constexpr std::uint64_t invalid_id_sum() const noexcept {
+        if ( !m_valid_range ) {
+            return 0;
+        }
+
+        uint128 sum{ 0 };
+        for ( auto n{ std::max( num_digits( m_first ), std::uint64_t{ 1 } ) };
+              n <= num_digits( m_last );
+              ++n ) {
+            const auto lo{ std::max( uint128{ m_first },
+                                     pow10_wide( n - 1 ) ) };
+            const auto hi{ std::min( uint128{ m_last },
+                                     pow10_wide( n ) - 1 ) };
+            sum += invalid_id_sum( lo, hi, n );
+        }
+        return static_cast<std::uint64_t>( sum );
+    }
+    // Sums invalid IDs in [first, last] by testing each one, so that
+    // enumerating a range can be split into independent pieces
+    static constexpr std::uint64_t
+    enumerated_invalid_id_sum( const std::uint64_t first,
+                               const std::uint64_t last ) noexcept {
+        assert( first <= last );
+
+        std::uint64_t sum{ 0 };
+        for ( auto id{ first };; ++id ) {
+            if ( !valid_id( id ) )
+                sum += id;
+            if ( id == last )
+                break;
+        }
+        return sum;
+    }
+    constexpr auto invalid_ids() const noexcept {
+        if ( !m_valid_range ) {
+            return std::vector<std::uint64_t>{};
+        }
+
+        return std::ranges::iota_view{ m_first, m_last + 1 }
+               | std::views::filter(
+                   []( const auto id ) { return !valid_id( id ); } )
+               | std::ranges::to<std::vector<std::uint64_t>>();
+    }
+};
+
+/*
+ * Enumerates every ID of every range on a work-stealing pool, for when
+ * the closed form is not wanted.
+ *  - One task per range, which cuts its range into sub-intervals of at
+ *    most chunk_size IDs with a nested parallel_for. Huge ranges still
+ *    spread over every worker through stealing and tiny ones cost a
+ *    single task, without listing every sub-interval up front.
+ *  - Each thread accumulates into its own cache line and the partial
+ *    sums are reduced once every range is done.
+ */
+template <Question Q>
+std::uint64_t
+parallel_invalid_id_sum( const std::vector<Range<Q>> & ranges,
+                         ThreadPool &                  pool,
+                         const std::uint64_t           chunk_size = 1 << 14 ) {
+    assert( chunk_size > 0 );
+
+    struct alignas( 64 ) PartialSum
+    {
+        std::uint64_t value{ 0 };
+    };
+    std::vector<PartialSum> partial_sums( pool.worker_count() + 1 );
+
+    pool.parallel_for( ranges.size(), [&]( const std::size_t i ) {
+        const auto & rng{ ranges[i] };
+        if ( !rng.is_valid() )
+            return;
+
+        const auto sum_chunk = [&]( const std::uint64_t chunk ) {
+            const auto lo{ rng.first() + chunk * chunk_size };
+            const auto hi{ rng.last() - lo < chunk_size ? rng.last() :
+                                                          lo + chunk_size - 1 };
+            partial_sums[pool.worker_index()].value +=
+                Range<Q>::enumerated_invalid_id_sum( lo, hi );
+        };
+
+        const auto n_chunks{ ( rng.last() - rng.first() ) / chunk_size + 1 };
+        if ( n_chunks == 1 )
+            sum_chunk( 0 );
+        else
+            pool.parallel_for( static_cast<std::size_t>( n_chunks ),
+                               sum_chunk );
+    } );
+
+    return std::ranges::fold_left(
+        partial_sums,
+        std::uint64_t{ 0 },
+        []( const auto sum, const auto & partial ) {
+            return sum + partial.value;
+        } );
+}
+
+template <Question Q>
+std::ostream &
+operator<<( std::ostream & os, const Range<Q> & rng ) {
+    const auto ids{ rng.ids() };
+
+    os << "Range{{ ";
+    if ( ids.size() < 31 ) {
+        for ( const auto id : ids ) { os << std::format( "{}, ", id ); }
+    }
+    else {
+        os << std::format( "{} - {} ",
+                           *std::min( ids.cbegin(), ids.cend() ),
+                           *std::max( ids.cbegin(), ids.cend() ) );
+    }
+    return os << "}}";
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "generator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <ostream>
+#include <random>
+#include <string>
+
+/*
+ * Synthetic day 2 input: count comma separated first-last ranges.
+ *  - The digit count of first is uniform in [1, max_digits] (at most 19),
+ *    then first is uniform among numbers of that many digits, so small
+ *    and huge IDs are equally represented.
+ *  - last = first + w with w uniform in [1, max_width].
+ * The real input has 33 ranges, the widest spanning ~1.2 million IDs.
+ * Nothing follows the last range, the range parser would reject it with a
+ * trailing newline.
+ */
+inline void
+generate_ranges( std::ostream & out, const std::uint64_t count,
+                 const std::uint64_t max_digits, const std::uint64_t max_width,
+                 const std::uint64_t seed ) {
+    std::mt19937_64 rng{ seed };
+
+    const auto digits_cap{ std::clamp( max_digits,
+                                       std::uint64_t{ 1 },
+                                       std::uint64_t{ 19 } ) };
+    const auto width_cap{ std::max( max_width, std::uint64_t{ 1 } ) };
+
+    std::string chunk{};
+    for ( std::uint64_t i{ 0 }; i < count; ++i ) {
+        const auto n_digits{ uniform_between( rng, 1, digits_cap ) };
+
+        const auto lowest{ pow10( n_digits - 1 ) };
+        const auto highest{ pow10( n_digits ) - 1 };
+
+        const auto first{ uniform_between( rng, lowest, highest ) };
+        // Keep last within uint64_t for 19 digit IDs
+        const auto width{ std::min( uniform_between( rng, 1, width_cap ),
+                                    UINT64_MAX - first ) };
+
+        std::format_to( std::back_inserter( chunk ),
+                        "{}{}-{}",
+                        i == 0 ? "" : ",",
+                        first,
+                        first + width );
+        if ( chunk.size() >= ( 1 << 16 ) ) {
+            out << chunk;
+            chunk.clear();
+        }
+    }
+    out << chunk;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "generator.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+
+/*
+ * Synthetic day 3 input: count banks of length digits, each uniform in
+ * [1, 9]. The real input has 200 banks of 100 digits.
+ */
+inline void
+generate_banks( std::ostream & out, const std::uint64_t count,
+                const std::uint64_t length, const std::uint64_t seed ) {
+    std::mt19937_64 rng{ seed };
+
+    std::string bank( length + 1, '\n' );
+    for ( std::uint64_t i{ 0 }; i < count; ++i ) {
+        for ( std::uint64_t j{ 0 }; j < length; ++j ) {
+            bank[j] = static_cast<char>( '1' + uniform_below( rng, 9 ) );
+        }
+        out << bank;
+    }
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "big_uint.hpp"
+#include "digits.hpp"
+#include "files.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// Joltages of up to 19 digits fit an unsigned long long. Longer ones use
+// a BigUInt with a spare limb.
+template <unsigned long long N>
+using joltage_t =
+    std::conditional_t<( N <= 19 ),
+                       unsigned long long,
+                       BigUInt<digits_to_limbs( static_cast<std::size_t>( N ) )
+                               + 1>>;
+
+// Sums over a Battery keep a limb above the widest joltage, so no number
+// of banks that fits a size_t can overflow them. Two 19 digit joltages
+// already overflow an unsigned long long.
+template <unsigned long long N>
+using joltage_sum_t =
+    BigUInt<digits_to_limbs( static_cast<std::size_t>( N ) ) + 1>;
+
+template <unsigned long long N>
+class Bank
+{
+    public:
+    using joltage_type = joltage_t<N>;
+
+    private:
+    joltage_type m_joltage;
+
+    static constexpr void append_digit( joltage_type &     joltage,
+                                        const std::uint8_t digit ) noexcept {
+        if constexpr ( std::is_same_v<joltage_type, unsigned long long> )
+            joltage = joltage * 10 + digit;
+        else
+            joltage.append_digit( digit );
+    }
+
+    /*
+     * Largest N digit subsequence of a digit sequence, fed one digit at a
+     * time.
+     *  - Digits are kept on a stack that stays non-increasing: a digit
+     *    pops every smaller digit before it, as long as enough digits are
+     *    left to still fill all N places.
+     *  - Each digit is pushed and popped at most once, so this is O(L) for
+     *    L digits and needs no storage beyond the N selected digits.
+     */
+    class StackSelection
+    {
+        private:
+        std::array<std::uint8_t, N> m_selected{};
+        std::size_t                 m_size{ 0 };
+        std::size_t                 m_droppable;
+
+        public:
+        constexpr explicit StackSelection( const std::size_t length ) :
+            m_droppable( length - N ) {
+            assert( N <= length );
+        }
+
+        constexpr void push( const std::uint8_t digit ) noexcept {
+            while ( m_droppable > 0 && m_size > 0
+                    && m_selected[m_size - 1] < digit ) {
+                --m_size;
+                --m_droppable;
+            }
+
+            if ( m_size < N )
+                m_selected[m_size++] = digit;
+            else
+                --m_droppable;
+        }
+
+        [[nodiscard]] constexpr joltage_type joltage() const noexcept {
+            joltage_type joltage{ 0 };
+            for ( const auto digit : m_selected ) {
+                append_digit( joltage, digit );
+            }
+            return joltage;
+        }
+    };
+
+    template <std::ranges::sized_range R>
+    static constexpr auto process_joltages( R && joltages ) {
+        StackSelection selection{ static_cast<std::size_t>(
+            std::ranges::size( joltages ) ) };
+        for ( const auto joltage : joltages ) {
+            selection.push( static_cast<std::uint8_t>( joltage ) );
+        }
+        return selection.joltage();
+    }
+
+    // Up to this N, digits are chosen by N window maximum searches. With
+    // the SIMD kernel stopping at the first '9' a search rarely reads more
+    // than one block, which beats pushing every digit through the stack.
+    static constexpr unsigned long long window_max_limit{ 16 };
+
+    // Digit k is the first largest digit that still leaves room for the
+    // N - k - 1 digits after it
+    static auto select_window_max( const std::string_view digits ) {
+        assert( N <= digits.size() );
+
+        joltage_type joltage{ 0 };
+        std::size_t  start{ 0 };
+        for ( std::size_t k{ 0 }; k < N; ++k ) {
+            const auto end{ digits.size() - N + k + 1 };
+            const auto index{ start
+                              + first_max_index( digits.data() + start,
+                                                 end - start ) };
+            append_digit( joltage,
+                          static_cast<std::uint8_t>( digits[index] - '0' ) );
+            start = index + 1;
+        }
+        return joltage;
+    }
+
+    // Stack selection over blocks of SIMD-decoded digits
+    static auto select_decoded( const std::string_view digits ) {
+        constexpr std::size_t block_size{ 256 };
+
+        StackSelection                       selection{ digits.size() };
+        std::array<std::uint8_t, block_size> block;
+        for ( std::size_t offset{ 0 }; offset < digits.size();
+              offset += block_size ) {
+            const auto size{ std::min( block_size, digits.size() - offset ) };
+            decode_digits( digits.data() + offset, size, block.data() );
+            for ( std::size_t i{ 0 }; i < size; ++i ) {
+                selection.push( block[i] );
+            }
+        }
+        return selection.joltage();
+    }
+
+    public:
+    constexpr Bank() = delete;
+    constexpr explicit Bank( const std::string_view unprocessed_input ) {
+        if consteval {
+            m_joltage = process_joltages(
+                unprocessed_input | std::views::transform( []( const char c ) {
+                    return static_cast<std::uint8_t>( c - '0' );
+                } ) );
+        }
+        else {
+            m_joltage = N <= window_max_limit ?
+                            select_window_max( unprocessed_input ) :
+                            select_decoded( unprocessed_input );
+        }
+    }
+    constexpr explicit Bank(
+        const std::vector<unsigned long long> & joltages ) :
+        m_joltage( process_joltages( joltages ) ) {}
+
+    constexpr Bank( const Bank & bank ) = default;
+    constexpr Bank( Bank && bank ) noexcept = default;
+
+    constexpr Bank & operator=( const Bank & bank ) = default;
+    constexpr Bank & operator=( Bank && bank ) = default;
+
+    constexpr ~Bank() = default;
+
+    [[nodiscard]] constexpr auto joltage() const noexcept { return m_joltage; }
+};
+
+/*
+ * Joltages of a set of banks, stored as one contiguous array.
+ *  - Only each bank's joltage is kept, 8 bytes per bank for N <= 19,
+ *    and the total is a single reduction over that array.
+ *  - Built from a whole input, the offset of every bank into it is kept
+ *    as well, so a bank can be traced back to its line.
+ *  - Accessors hand out spans, never copies.
+ */
+template <unsigned long long N>
+class Battery
+{
+    private:
+    std::vector<joltage_t<N>> m_joltages;
+    std::vector<std::size_t>  m_offsets;
+
+    public:
+    constexpr Battery() = delete;
+    template <record_range R>
+    constexpr Battery( R && unprocessed_input ) :
+        m_joltages( unprocessed_input
+                    | std::views::transform( []( const auto view ) {
+                          return Bank<N>{ view }.joltage();
+                      } )
+                    | std::ranges::to<std::vector<joltage_t<N>>>() ),
+        m_offsets() {}
+    // Every non-empty line of input is a bank
+    constexpr explicit Battery( const std::string_view input ) :
+        m_joltages(), m_offsets() {
+        for ( const auto line : split_input( input ) ) {
+            if ( line.empty() )
+                continue;
+            m_offsets.push_back(
+                static_cast<std::size_t>( line.data() - input.data() ) );
+            m_joltages.push_back( Bank<N>{ line }.joltage() );
+        }
+    }
+    /*
+     * Evaluates the banks in chunks of chunk_size on pool.
+     *  - Every chunk writes its own slice of the joltages, so the result
+     *    does not depend on the thread count.
+     *  - The views must stay valid until construction is done, so banks
+     *    cannot come from a RecordStream.
+     */
+    Battery( const std::span<const std::string_view> banks, ThreadPool & pool,
+             const std::size_t chunk_size = 1 << 12 ) :
+        m_joltages( banks.size() ), m_offsets() {
+        assert( chunk_size > 0 );
+
+        const auto n_chunks{ ( banks.size() + chunk_size - 1 ) / chunk_size };
+        pool.parallel_for( n_chunks, [&]( const std::size_t i ) {
+            const auto first{ i * chunk_size };
+            const auto last{ std::min( first + chunk_size, banks.size() ) };
+            for ( auto j{ first }; j < last; ++j ) {
+                m_joltages[j] = Bank<N>{ banks[j] }.joltage();
+            }
+        } );
+    }
+    constexpr Battery(
+        const std::vector<std::vector<unsigned long long>> & joltage_banks ) :
+        m_joltages( joltage_banks
+                    | std::views::transform( []( const auto & bank ) {
+                          return Bank<N>{ bank }.joltage();
+                      } )
+                    | std::ranges::to<std::vector<joltage_t<N>>>() ),
+        m_offsets() {}
+
+    constexpr Battery( const Battery & battery ) = default;
+    constexpr Battery( Battery && battery ) = default;
+
+    constexpr Battery & operator=( const Battery & battery ) = default;
+    constexpr Battery & operator=( Battery && battery ) noexcept = default;
+
+    constexpr ~Battery() = default;
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return m_joltages.size();
+    }
+    [[nodiscard]] constexpr std::span<const joltage_t<N>>
+    joltages() const noexcept {
+        return m_joltages;
+    }
+    // Empty unless built from a whole input
+    [[nodiscard]] constexpr std::span<const std::size_t>
+    offsets() const noexcept {
+        return m_offsets;
+    }
+    [[nodiscard]] constexpr joltage_sum_t<N> joltage() const noexcept {
+        return std::ranges::fold_left(
+            m_joltages, joltage_sum_t<N>{ 0 }, std::plus{} );
+    }
+};
@@ -1,119 +1,21 @@
+#include "battery.hpp"
 #include "constants.hpp"
 #include "files.hpp"
+#include "thread_pool.hpp"
 
+#include <algorithm>
 #include <cassert>
-#include <cmath>
-#include <functional>
-#include <numeric>
+#include <cstddef>
+#include <format>
+#include <string>
+#include <string_view>
+#include <vector>
 
-template <unsigned long long N>
-class Bank
-{
-    private:
-    unsigned long long m_joltage;
-
-    static constexpr auto
-    process_joltages( const std::vector<unsigned long long> joltages ) {
-        assert( N < joltages.size() );
-
-        // Calculate search end position so all N numbers can fit
-        auto end_pos{ joltages.size() - N + 1 };
-
-        // Find first max number
-        auto first_it{ std::max_element(
-            joltages.cbegin(), std::next( joltages.cbegin(), end_pos ) ) };
-
-        bool               first_time{ true };
-        unsigned long long joltage{ 0 };
-        while ( first_it != joltages.cend()
-                && ( std::next( joltages.cbegin(), end_pos ) != joltages.cend()
-                     || first_time ) ) {
-            assert( first_it != std::next( joltages.cbegin(), end_pos ) );
-
-            first_time = false;
-
-            joltage += *first_it
-                       * static_cast<unsigned long long>(
-                           std::pow( 10, joltages.size() - end_pos ) );
-
-            // Find next max number
-            first_it =
-                std::max_element( std::next( first_it ),
-                                  std::next( joltages.cbegin(), ++end_pos ) );
-        }
-
-        joltage += *first_it;
-
-        return joltage;
-    }
-
-    public:
-    constexpr Bank() = delete;
-    constexpr explicit Bank( const std::string_view unprocessed_input ) {
-        const auto joltages =
-            std::views::all( unprocessed_input )
-            | std::views::transform( []( const auto character ) {
-                  return static_cast<unsigned long long>( character )
-                         - static_cast<unsigned long long>( '0' );
-              } )
-            | std::ranges::to<std::vector<unsigned long long>>();
-
-        m_joltage = process_joltages( joltages );
-    };
-    constexpr explicit Bank(
-        const std::vector<unsigned long long> & joltages ) :
-        m_joltage( process_joltages( joltage ) ) {}
-
-    constexpr Bank( const Bank & bank ) = default;
-    constexpr Bank( Bank && bank ) noexcept = default;
-
-    constexpr Bank & operator=( const Bank & bank ) = default;
-    constexpr Bank & operator=( Bank && bank ) = default;
+#ifdef AOC_CONSTEVAL
+#include "embedded_input.hpp"
+#endif
 
-    constexpr ~Bank() = default;
-
-    [[nodiscard]] constexpr auto joltage() const noexcept { return m_joltage; }
-};
-
-template <unsigned long long N>
-class Battery
-{
-    private:
-    std::vector<Bank<N>> m_banks;
-
-    public:
-    constexpr Battery() = delete;
-    constexpr Battery(
-        const std::vector<std::string_view> & unprocessed_input ) :
-        m_banks( unprocessed_input
-                 | std::views::transform(
-                     []( const auto view ) { return Bank<N>{ view }; } )
-                 | std::ranges::to<std::vector<Bank<N>>>() ) {};
-    constexpr Battery(
-        const std::vector<std::vector<unsigned long long>> & joltage_banks ) :
-        m_banks( joltage_banks
-                 | std::views::transform(
-                     []( const auto & bank ) { return Bank{ bank }; } )
-                 | std::ranges::to<std::vector<Bank<N>>>() ) {};
-
-    constexpr Battery( const Battery & battery ) = default;
-    constexpr Battery( Battery && battery ) = default;
-
-    constexpr Battery & operator=( const Battery & battery ) = default;
-    constexpr Battery & operator=( Battery && battery ) noexcept = default;
-
-    constexpr ~Battery() = default;
-
-    [[nodiscard]] constexpr auto banks() const noexcept { return m_banks; }
-    [[nodiscard]] constexpr auto joltage() const noexcept {
-        return std::accumulate( m_banks.cbegin(),
-                                m_banks.cend(),
-                                static_cast<unsigned long long>( 0 ),
-                                []( const auto sum, const auto & bank ) {
-                                    return sum + bank.joltage();
-                                } );
-    }
-};
+enum class Evaluation { Serial, Parallel };
 
 static const std::string_view test_input{
     "987654321111111\n811111111111119\n234234234234278\n818181911112111"
@@ -123,38 +25,49 @@ static const std::vector<unsigned long long> test_bank_joltages_1{
     98, 89, 78, 92
 };
 static const unsigned long long test_joltage_sum_1{ 357 };
+static const std::vector<std::size_t> test_bank_offsets{ 0, 16, 32, 48 };
 
 static const std::vector<unsigned long long> test_bank_joltages_2{
     987654321111, 811111111119, 434234234278, 888911112111
 };
 static const unsigned long long test_joltage_sum_2{ 3121910778619 };
 
+// test_input banks doubled, with more digits selected than an unsigned
+// long long can hold
+static const std::vector<std::string_view> test_long_input{
+    "987654321111111987654321111111",
+    "811111111111119811111111111119",
+    "234234234234278234234234234278",
+    "818181911112111818181911112111"
+};
+
+static const std::vector<std::string_view> test_long_bank_joltages{
+    "9876543211987654321111111",
+    "8111111119811111111111119",
+    "4434234278234234234234278",
+    "8911112111818181911112111"
+};
+static const std::string_view test_long_joltage_sum{
+    "31333000721851181577568619"
+};
+
 constexpr void
 test_function_1() {
-    const Battery<2> test( std::views::all( test_input )
-                           | std::views::split( '\n' )
-                           | std::views::transform( []( const auto & x ) {
-                                 return std::string_view{ x.data(), x.size() };
-                             } )
-                           | std::ranges::to<std::vector<std::string_view>>() );
+    const Battery<2> test( test_input );
 
     const auto bank_results{
         std::views::zip_transform(
             []( const auto bank_joltage, const auto expected_joltage ) {
                 return bank_joltage == expected_joltage;
             },
-            test.banks() | std::views::transform( []( const auto & bank ) {
-                return bank.joltage();
-            } ) | std::ranges::to<std::vector<unsigned long long>>(),
+            test.joltages(),
             test_bank_joltages_1 )
         | std::ranges::to<std::vector<bool>>()
     };
 
     std::println(
         "bank_results:     {}\nexpected_results: {}",
-        test.banks() | std::views::transform( []( const auto & bank ) {
-            return bank.joltage();
-        } ) | std::ranges::to<std::vector<unsigned long long>>(),
+        test.joltages(),
         test_bank_joltages_1 );
     std::println( "Total Joltage: {}\nExpected Total Joltage: {}",
                   test.joltage(),
@@ -164,6 +77,7 @@ test_function_1() {
                          bank_results.cend(),
                          []( const auto result ) { return result == true; } ) );
     assert( test.joltage() == test_joltage_sum_1 );
+    assert( std::ranges::equal( test.offsets(), test_bank_offsets ) );
 }
 
 constexpr void
@@ -180,18 +94,14 @@ test_function_2() {
             []( const auto bank_joltage, const auto expected_joltage ) {
                 return bank_joltage == expected_joltage;
             },
-            test.banks() | std::views::transform( []( const auto & bank ) {
-                return bank.joltage();
-            } ) | std::ranges::to<std::vector<unsigned long long>>(),
+            test.joltages(),
             test_bank_joltages_2 )
         | std::ranges::to<std::vector<bool>>()
     };
 
     std::println(
         "bank_results:     {}\nexpected_results: {}",
-        test.banks() | std::views::transform( []( const auto & bank ) {
-            return bank.joltage();
-        } ) | std::ranges::to<std::vector<unsigned long long>>(),
+        test.joltages(),
         test_bank_joltages_2 );
     std::println( "Total Joltage: {}\nExpected Total Joltage: {}",
                   test.joltage(),
@@ -203,35 +113,145 @@ test_function_2() {
     assert( test.joltage() == test_joltage_sum_2 );
 }
 
-constexpr auto
-problem_1( const auto input ) {
-    Battery<2> battery{ std::views::all( input ) | std::views::split( '\n' )
-                        | std::views::transform( []( const auto & x ) {
-                              return std::string_view{ x.data(), x.size() };
-                          } )
-                        | std::views::filter(
-                            []( const auto view ) { return !view.empty(); } )
-                        | std::ranges::to<std::vector<std::string_view>>() };
-    std::println( "Battery joltage: {}", battery.joltage() );
+void
+test_function_long() {
+    const Battery<25> test( test_long_input );
+
+    const auto bank_joltages{
+        test.joltages() | std::views::transform( []( const auto & joltage ) {
+            return std::format( "{}", joltage );
+        } )
+        | std::ranges::to<std::vector<std::string>>()
+    };
+    const auto joltage{ std::format( "{}", test.joltage() ) };
+
+    std::println( "bank_results:     {}\nexpected_results: {}",
+                  bank_joltages,
+                  test_long_bank_joltages );
+    std::println( "Total Joltage: {}\nExpected Total Joltage: {}",
+                  joltage,
+                  test_long_joltage_sum );
+
+    assert( std::ranges::equal( bank_joltages, test_long_bank_joltages ) );
+    assert( joltage == test_long_joltage_sum );
+}
+
+// Banks whose joltages fit an unsigned long long, but whose sum does not
+void
+test_function_wide_sum() {
+    const Battery<19> test( "9999999999999999999\n9999999999999999999" );
+
+    const auto joltage{ std::format( "{}", test.joltage() ) };
+    std::println( "Total Joltage: {}\nExpected Total Joltage: {}",
+                  joltage,
+                  "19999999999999999998" );
+
+    assert( joltage == "19999999999999999998" );
+}
+
+// Banks evaluated in chunks on a pool must match the serial Battery, with
+// chunks small enough to split the input
+template <unsigned long long N>
+void
+test_function_parallel() {
+    const auto banks{ split_input( test_input ) };
+
+    ThreadPool pool{ 4 };
+    for ( const std::size_t chunk_size : { 1, 3 } ) {
+        const Battery<N> test( banks, pool, chunk_size );
+        const Battery<N> serial( test_input );
+
+        std::println( "Parallel Joltage: {} (chunk size {})\n"
+                      "Serial Joltage:   {}",
+                      test.joltage(),
+                      chunk_size,
+                      serial.joltage() );
+
+        assert( std::ranges::equal( test.joltages(), serial.joltages() ) );
+        assert( test.joltage() == serial.joltage() );
+    }
+}
+
+// Parallel evaluation needs every record in memory at once
+template <unsigned long long N>
+auto
+battery_joltage( record_range auto && input, const Evaluation evaluation ) {
+    auto banks{ input | std::views::filter( []( const auto view ) {
+                    return !std::string_view{ view }.empty();
+                } ) };
+
+    if ( evaluation == Evaluation::Parallel ) {
+        ThreadPool pool{};
+        return Battery<N>{
+            banks | std::ranges::to<std::vector<std::string_view>>(), pool }
+            .joltage();
+    }
+
+    return Battery<N>{ banks }.joltage();
+}
+
+auto
+problem_1( record_range auto && input, const Evaluation evaluation ) {
+    std::println( "Battery joltage: {}",
+                  battery_joltage<2>( input, evaluation ) );
 }
 
-constexpr auto
-problem_2( const auto input ) {
-    Battery<12> battery{ std::views::all( input ) | std::views::split( '\n' )
-                         | std::views::transform( []( const auto & x ) {
-                               return std::string_view{ x.data(), x.size() };
-                           } )
-                         | std::views::filter(
-                             []( const auto view ) { return !view.empty(); } )
-                         | std::ranges::to<std::vector<std::string_view>>() };
-    std::println( "Battery joltage: {}", battery.joltage() );
+auto
+problem_2( record_range auto && input, const Evaluation evaluation ) {
+    std::println( "Battery joltage: {}",
+                  battery_joltage<12>( input, evaluation ) );
+}
+
+#ifdef AOC_CONSTEVAL
+// Every bank of the embedded input, selected by the compiler
+template <unsigned long long N>
+consteval joltage_sum_t<N>
+constant_joltage() {
+    return Battery<N>{ embedded_input }.joltage();
 }
 
+static_assert( Battery<2>{ "987654321111111\n811111111111119\n"
+                           "234234234234278\n818181911112111" }
+                   .joltage()
+               == 357 );
+#endif
+
+// Pass --parallel to evaluate banks on all cores. The input is then read
+// whole rather than streamed.
 int
-main() {
-    const auto input{ get_input_file( 3 ) };
+main( const int argc, char ** argv ) {
+#ifdef AOC_CONSTEVAL
+    // Everything was computed while compiling
+    std::println( "Battery joltage: {}", constant_joltage<2>() );
+    std::println( "Battery joltage: {}", constant_joltage<12>() );
+    return 0;
+#endif
+
+    const bool parallel{ argc > 1
+                         && std::string_view{ argv[1] } == "--parallel" };
+
     test_function_1();
-    problem_1( input );
     test_function_2();
-    problem_2( input );
+    test_function_long();
+    test_function_wide_sum();
+    test_function_parallel<2>();
+    test_function_parallel<12>();
+
+    if ( parallel ) {
+        const auto input{ get_input_file( 3 ) };
+        const auto lines{ split_input( input ) };
+        problem_1( lines, Evaluation::Parallel );
+        problem_2( lines, Evaluation::Parallel );
+        return 0;
+    }
+
+    auto banks_1{ stream_input_file( 3 ) };
+    problem_1( banks_1, Evaluation::Serial );
+    auto banks_2{ stream_input_file( 3 ) };
+    problem_2( banks_2, Evaluation::Serial );
+
+    if ( banks_1.failed() || banks_2.failed() ) {
+        std::println( "Input was not read whole, the joltages are partial." );
+        return 1;
+    }
 }
@@ -0,0 +1,16 @@
+#include "bank_generator.hpp"
+
+/*
+ * Usage: day3_generate [--count=N] [--length=N] [--seed=N]
+ *                      [--output=path]
+ */
+int
+main( const int argc, char ** argv ) {
+    const GeneratorArgs args{ argc, argv };
+    return args.run( [&args]( std::ostream & out ) {
+        generate_banks( out,
+                        args.get( "count", 1'000 ),
+                        args.get( "length", 1'000 ),
+                        args.seed() );
+    } );
+}
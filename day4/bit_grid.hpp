@@ -0,0 +1,198 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * One bit per cell grid (bitboard).
+ *  - Cell (i, j) is bit i % 64 of word i / 64 of row j. Rows are padded
+ *    to whole words, the padding bits are always 0.
+ *  - Every row has a zero halo word on each side, and a zero halo row
+ *    sits above the first and below the last row, so neighbour lookups
+ *    never need a bounds check on i or j.
+ *  - neighbour_count computes the number of set 8-neighbours of all 64
+ *    cells of a word at once, as a bit-sliced (one bit plane per binary
+ *    digit) sum of the shifted neighbour rows.
+ */
+
+class BitGrid
+{
+    public:
+    using word_type = std::uint64_t;
+    static constexpr std::uint32_t word_bits{ 64 };
+
+    // Bit planes of a per-cell count in [0, 8]: bit b of the count of
+    // cell k is bit k of the plane with weight 2^b
+    struct NeighbourCount
+    {
+        word_type ones;
+        word_type twos;
+        word_type fours;
+        word_type eights;
+
+        // Cells with at least four neighbours
+        [[nodiscard]] constexpr word_type at_least_four() const noexcept {
+            return fours | eights;
+        }
+    };
+
+    private:
+    std::uint32_t          m_width;
+    std::uint32_t          m_height;
+    std::uint32_t          m_words_per_row;
+    std::uint32_t          m_stride;
+    std::vector<word_type> m_words;
+
+    // Row j of the grid is guarded row j + 1, word w of a row is at
+    // offset w (the halo words are at -1 and m_words_per_row)
+    [[nodiscard]] constexpr const word_type *
+    guarded_row( const std::size_t row ) const noexcept {
+        return m_words.data() + row * m_stride + 1;
+    }
+    [[nodiscard]] constexpr word_type *
+    guarded_row( const std::size_t row ) noexcept {
+        return m_words.data() + row * m_stride + 1;
+    }
+
+    struct AdderResult
+    {
+        word_type sum;
+        word_type carry;
+    };
+
+    static constexpr AdderResult
+    full_add( const word_type a, const word_type b,
+              const word_type c ) noexcept {
+        const auto partial{ a ^ b };
+        return { partial ^ c, ( a & b ) | ( partial & c ) };
+    }
+
+    public:
+    constexpr BitGrid() = delete;
+    constexpr BitGrid( const std::uint32_t width, const std::uint32_t height ) :
+        m_width( width ),
+        m_height( height ),
+        m_words_per_row( ( width + word_bits - 1 ) / word_bits ),
+        m_stride( m_words_per_row + 2 ),
+        m_words( static_cast<std::size_t>( height + 2 ) * m_stride, 0 ) {}
+
+    constexpr BitGrid( const BitGrid & ) = default;
+    constexpr BitGrid( BitGrid && ) noexcept = default;
+
+    constexpr BitGrid & operator=( const BitGrid & ) = default;
+    constexpr BitGrid & operator=( BitGrid && ) noexcept = default;
+
+    constexpr ~BitGrid() = default;
+
+    [[nodiscard]] friend constexpr bool
+    operator==( const BitGrid &, const BitGrid & ) noexcept = default;
+
+    [[nodiscard]] constexpr auto width() const noexcept { return m_width; }
+    [[nodiscard]] constexpr auto height() const noexcept { return m_height; }
+    [[nodiscard]] constexpr auto words_per_row() const noexcept {
+        return m_words_per_row;
+    }
+
+    [[nodiscard]] constexpr std::span<const word_type>
+    row( const std::uint32_t j ) const noexcept {
+        assert( j < m_height );
+        return { guarded_row( j + 1 ), m_words_per_row };
+    }
+    [[nodiscard]] constexpr std::span<word_type>
+    row( const std::uint32_t j ) noexcept {
+        assert( j < m_height );
+        return { guarded_row( j + 1 ), m_words_per_row };
+    }
+
+    [[nodiscard]] constexpr bool test( const std::uint32_t i,
+                                       const std::uint32_t j ) const noexcept {
+        assert( i < m_width && j < m_height );
+        return ( guarded_row( j + 1 )[i / word_bits] >> ( i % word_bits ) )
+               & 1;
+    }
+
+    constexpr void set( const std::uint32_t i, const std::uint32_t j,
+                        const bool value = true ) noexcept {
+        assert( i < m_width && j < m_height );
+        auto &     word{ guarded_row( j + 1 )[i / word_bits] };
+        const auto bit{ word_type{ 1 } << ( i % word_bits ) };
+        word = value ? word | bit : word & ~bit;
+    }
+
+    constexpr void reset( const std::uint32_t i,
+                          const std::uint32_t j ) noexcept {
+        set( i, j, false );
+    }
+
+    [[nodiscard]] constexpr std::uint64_t count() const noexcept {
+        return std::ranges::fold_left(
+            m_words, std::uint64_t{ 0 }, []( const auto sum, const auto word ) {
+                return sum + static_cast<std::uint64_t>( std::popcount( word ) );
+            } );
+    }
+
+    // Set cells in rows [first_row, last_row)
+    [[nodiscard]] constexpr std::uint64_t
+    count( const std::uint32_t first_row,
+           const std::uint32_t last_row ) const noexcept {
+        assert( first_row <= last_row && last_row <= m_height );
+        std::uint64_t total{ 0 };
+        for ( auto j{ first_row }; j < last_row; ++j ) {
+            for ( const auto word : row( j ) ) {
+                total += static_cast<std::uint64_t>( std::popcount( word ) );
+            }
+        }
+        return total;
+    }
+
+    /*
+     * Neighbour counts of the 64 cells in word w of row j.
+     *  - The west neighbours of a word are the row shifted up by one bit,
+     *    pulling in the top bit of the previous word; east is the mirror.
+     *    The halo words make both branch-free at the row ends.
+     *  - Above and below are summed three at a time with full adders,
+     *    the middle row's two neighbours with a half adder, then the three
+     *    2-bit sums are added into the four count planes.
+     * Counts in the padding bits are meaningless, mask them out.
+     */
+    [[nodiscard]] constexpr NeighbourCount
+    neighbour_count( const std::uint32_t j,
+                     const std::uint32_t w ) const noexcept {
+        assert( j < m_height && w < m_words_per_row );
+
+        // word[-1] and word[1] may be halo words
+        const auto west = []( const word_type * word ) {
+            return ( word[0] << 1 ) | ( word[-1] >> ( word_bits - 1 ) );
+        };
+        const auto east = []( const word_type * word ) {
+            return ( word[0] >> 1 ) | ( word[1] << ( word_bits - 1 ) );
+        };
+
+        const auto * above{ guarded_row( j ) + w };
+        const auto * middle{ guarded_row( j + 1 ) + w };
+        const auto * below{ guarded_row( j + 2 ) + w };
+
+        const auto top{ full_add( west( above ), *above, east( above ) ) };
+        const auto bottom{ full_add( west( below ), *below, east( below ) ) };
+        const auto middle_west{ west( middle ) };
+        const auto middle_east{ east( middle ) };
+        const AdderResult centre{ middle_west ^ middle_east,
+                                  middle_west & middle_east };
+
+        const auto ones{ full_add( top.sum, bottom.sum, centre.sum ) };
+        const auto twos{ full_add( top.carry, bottom.carry, centre.carry ) };
+        // Four weight-2 bits: the three above plus the carry from the ones
+        const AdderResult twos_carry{ twos.sum ^ ones.carry,
+                                      twos.sum & ones.carry };
+
+        return { ones.sum,
+                 twos_carry.sum,
+                 twos.carry ^ twos_carry.carry,
+                 twos.carry & twos_carry.carry };
+    }
+};
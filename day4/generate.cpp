@@ -0,0 +1,17 @@
+#include "grid_generator.hpp"
+
+/*
+ * Usage: day4_generate [--width=N] [--height=N] [--density=percent]
+ *                      [--seed=N] [--output=path]
+ */
+int
+main( const int argc, char ** argv ) {
+    const GeneratorArgs args{ argc, argv };
+    return args.run( [&args]( std::ostream & out ) {
+        generate_grid( out,
+                       args.get( "width", 1'000 ),
+                       args.get( "height", 1'000 ),
+                       args.get( "density", 65 ),
+                       args.seed() );
+    } );
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "generator.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <random>
+#include <string>
+
+/*
+ * Synthetic day 4 input: a width x height grid where each cell is a
+ * roll of paper ('@') with probability density / 100, otherwise empty
+ * ('.'). The real input is 135 x 136 with ~65% paper. Rows are written
+ * one at a time, so 100k x 100k grids only need one row of memory.
+ */
+inline void
+generate_grid( std::ostream & out, const std::uint64_t width,
+               const std::uint64_t height, const std::uint64_t density,
+               const std::uint64_t seed ) {
+    std::mt19937_64 rng{ seed };
+
+    std::string row( width + 1, '\n' );
+    for ( std::uint64_t j{ 0 }; j < height; ++j ) {
+        for ( std::uint64_t i{ 0 }; i < width; ++i ) {
+            row[i] = uniform_below( rng, 100 ) < density ? '@' : '.';
+        }
+        out << row;
+    }
+}
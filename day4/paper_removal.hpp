@@ -0,0 +1,254 @@
+#pragma once
+
+#include "bit_grid.hpp"
+#include "map.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Repeated removal of accessible paper, run incrementally.
+ *  - Every remaining roll keeps a count of its remaining neighbours,
+ *    stored in a grid with a one cell border so that updating the 8
+ *    neighbours of a cell needs no bounds checks.
+ *  - Removing a roll decrements its neighbours' counts. A roll joins the
+ *    frontier exactly once, when its count first drops below four (or at
+ *    the start, if it is already accessible).
+ *  - Removal order does not change the final state: a roll that becomes
+ *    accessible stays accessible, so total work is O(cells + removals)
+ *    rather than O(passes x cells).
+ *  - Padded indices and counts are 64-bit, a grid of 65536 x 65536 cells
+ *    already has more than 2^32 of them.
+ */
+
+class PaperRemoval
+{
+    private:
+    // Count value of cells that are not (or no longer) paper
+    static constexpr std::uint8_t no_paper{ 0xff };
+    static constexpr std::uint8_t accessible_limit{ 4 };
+
+    std::uint32_t             m_width;
+    std::uint32_t             m_height;
+    std::size_t               m_stride;
+    std::vector<std::uint8_t> m_counts;
+    std::vector<std::size_t>  m_frontier;
+    BitGrid                   m_remaining;
+    std::uint64_t             m_removed;
+
+    [[nodiscard]] constexpr std::size_t
+    padded_index( const std::uint32_t i, const std::uint32_t j ) const noexcept {
+        return ( std::size_t{ j } + 1 ) * m_stride + ( std::size_t{ i } + 1 );
+    }
+
+    // Unpadded column and row of a padded index
+    [[nodiscard]] constexpr std::uint32_t
+    column( const std::size_t index ) const noexcept {
+        return static_cast<std::uint32_t>( index % m_stride - 1 );
+    }
+    [[nodiscard]] constexpr std::uint32_t
+    row( const std::size_t index ) const noexcept {
+        return static_cast<std::uint32_t>( index / m_stride - 1 );
+    }
+
+    // Seeds counts and the frontier from the bit-sliced neighbour counts
+    constexpr void initialise( const Map & map ) {
+        const auto & paper{ map.paper() };
+        const auto & accessible{ map.accessible() };
+
+        for ( std::uint32_t j{ 0 }; j < m_height; ++j ) {
+            const auto paper_row{ paper.row( j ) };
+            const auto accessible_row{ accessible.row( j ) };
+            for ( std::uint32_t w{ 0 }; w < paper.words_per_row(); ++w ) {
+                const auto counts{ paper.neighbour_count( j, w ) };
+
+                auto remaining{ paper_row[w] };
+                while ( remaining != 0 ) {
+                    const auto bit{ static_cast<std::uint32_t>(
+                        std::countr_zero( remaining ) ) };
+                    const auto index{ padded_index(
+                        w * BitGrid::word_bits + bit, j ) };
+
+                    m_counts[index] = static_cast<std::uint8_t>(
+                        ( ( counts.ones >> bit ) & 1 )
+                        | ( ( ( counts.twos >> bit ) & 1 ) << 1 )
+                        | ( ( ( counts.fours >> bit ) & 1 ) << 2 )
+                        | ( ( ( counts.eights >> bit ) & 1 ) << 3 ) );
+                    if ( ( accessible_row[w] >> bit ) & 1 )
+                        m_frontier.push_back( index );
+
+                    remaining &= remaining - 1;
+                }
+            }
+        }
+    }
+
+    public:
+    constexpr PaperRemoval() = delete;
+    constexpr explicit PaperRemoval( const Map & map ) :
+        m_width( map.width() ),
+        m_height( map.height() ),
+        m_stride( std::size_t{ map.width() } + 2 ),
+        m_counts( ( std::size_t{ map.height() } + 2 ) * m_stride, no_paper ),
+        m_frontier(),
+        m_remaining( map.paper() ),
+        m_removed( 0 ) {
+        m_frontier.reserve( map.accessible_paper() );
+        initialise( map );
+    }
+
+    constexpr PaperRemoval( const PaperRemoval & ) = default;
+    constexpr PaperRemoval( PaperRemoval && ) noexcept = default;
+
+    constexpr PaperRemoval & operator=( const PaperRemoval & ) = default;
+    constexpr PaperRemoval & operator=( PaperRemoval && ) noexcept = default;
+
+    constexpr ~PaperRemoval() = default;
+
+    // Removes paper until none is accessible, returns the total removed
+    constexpr std::uint64_t run() {
+        const auto         stride{ static_cast<std::int64_t>( m_stride ) };
+        const std::int64_t neighbour_offsets[]{
+            -stride - 1, -stride, -stride + 1, -1, 1,
+            stride - 1,  stride,  stride + 1
+        };
+
+        while ( !m_frontier.empty() ) {
+            const auto index{ m_frontier.back() };
+            m_frontier.pop_back();
+
+            m_counts[index] = no_paper;
+            m_remaining.reset( column( index ), row( index ) );
+            ++m_removed;
+
+            for ( const auto offset : neighbour_offsets ) {
+                const auto neighbour{ static_cast<std::size_t>(
+                    static_cast<std::int64_t>( index ) + offset ) };
+                auto & count{ m_counts[neighbour] };
+                if ( count != no_paper && --count == accessible_limit - 1 )
+                    m_frontier.push_back( neighbour );
+            }
+        }
+
+        return m_removed;
+    }
+
+    /*
+     * Same result as run(), with the rows split into bands of band_rows
+     * rows that are worked on in parallel on pool, in rounds.
+     *  - Each band owns the counts of its rows and drains its own frontier,
+     *    cascading within the band as run() does.
+     *  - Decrements that fall on the row above or below the band are not
+     *    applied but posted to the neighbouring band.
+     *  - Once every band is idle (the barrier) each band applies the
+     *    decrements posted to it, which may refill its frontier.
+     * Rounds repeat until every frontier is empty. Since removal order does
+     * not change the final state, neither does the banding.
+     */
+    std::uint64_t run( ThreadPool &        pool,
+                       const std::uint32_t band_rows = Map::default_band_rows ) {
+        assert( band_rows > 0 );
+
+        struct alignas( 64 ) Band
+        {
+            std::vector<std::size_t> frontier{};
+            std::vector<std::size_t> to_above{};
+            std::vector<std::size_t> to_below{};
+            std::uint64_t            removed{ 0 };
+        };
+
+        const auto n_bands{ ( m_height + band_rows - 1 ) / band_rows };
+        std::vector<Band> bands( n_bands );
+
+        // Padded rows of band b are [b * band_rows + 1, ... + band_rows]
+        const auto band_of = [&]( const std::size_t index ) {
+            return row( index ) / band_rows;
+        };
+
+        for ( const auto index : m_frontier ) {
+            bands[band_of( index )].frontier.push_back( index );
+        }
+        m_frontier.clear();
+
+        const auto         stride{ static_cast<std::int64_t>( m_stride ) };
+        const std::int64_t neighbour_offsets[]{
+            -stride - 1, -stride, -stride + 1, -1, 1,
+            stride - 1,  stride,  stride + 1
+        };
+
+        const auto drain = [&]( const std::size_t b ) {
+            auto &     band{ bands[b] };
+            const auto first_index{ ( b * band_rows + 1 ) * m_stride };
+            const auto last_index{
+                ( std::min( ( b + 1 ) * band_rows, std::size_t{ m_height } )
+                  + 1 )
+                * m_stride
+            };
+
+            while ( !band.frontier.empty() ) {
+                const auto index{ band.frontier.back() };
+                band.frontier.pop_back();
+
+                m_counts[index] = no_paper;
+                m_remaining.reset( column( index ), row( index ) );
+                ++band.removed;
+
+                for ( const auto offset : neighbour_offsets ) {
+                    const auto neighbour{ static_cast<std::size_t>(
+                        static_cast<std::int64_t>( index ) + offset ) };
+                    if ( neighbour < first_index ) {
+                        if ( b > 0 )
+                            band.to_above.push_back( neighbour );
+                        continue;
+                    }
+                    if ( neighbour >= last_index ) {
+                        if ( b + 1 < n_bands )
+                            band.to_below.push_back( neighbour );
+                        continue;
+                    }
+
+                    auto & count{ m_counts[neighbour] };
+                    if ( count != no_paper && --count == accessible_limit - 1 )
+                        band.frontier.push_back( neighbour );
+                }
+            }
+        };
+
+        const auto receive = [&]( const std::size_t b ) {
+            auto &     band{ bands[b] };
+            const auto apply = [&]( std::vector<std::size_t> & messages ) {
+                for ( const auto neighbour : messages ) {
+                    auto & count{ m_counts[neighbour] };
+                    if ( count != no_paper && --count == accessible_limit - 1 )
+                        band.frontier.push_back( neighbour );
+                }
+                messages.clear();
+            };
+
+            if ( b > 0 )
+                apply( bands[b - 1].to_below );
+            if ( b + 1 < n_bands )
+                apply( bands[b + 1].to_above );
+        };
+
+        while ( std::ranges::any_of( bands, []( const Band & band ) {
+            return !band.frontier.empty();
+        } ) ) {
+            pool.parallel_for( n_bands, drain );
+            pool.parallel_for( n_bands, receive );
+        }
+
+        for ( const auto & band : bands ) { m_removed += band.removed; }
+        return m_removed;
+    }
+
+    [[nodiscard]] constexpr auto removed() const noexcept { return m_removed; }
+    [[nodiscard]] constexpr const BitGrid & remaining() const noexcept {
+        return m_remaining;
+    }
+};
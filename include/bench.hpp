@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <print>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Self-contained micro-benchmark harness, modelled on Google Benchmark.
+ *  - A benchmark is a function taking a BenchState. Setup happens before
+ *    the first keep_running() call and is not timed:
+ *        suite.add( "name", []( BenchState & state ) {
+ *            const auto data{ ... };
+ *            while ( state.keep_running() ) { do_not_optimize( f( data ) ); }
+ *        } );
+ *  - The iteration count grows until a run takes at least min_time.
+ *  - Results are printed as a table and written as JSON in the same shape
+ *    as Google Benchmark's --benchmark_out, so existing tooling can diff
+ *    runs for regressions.
+ */
+
+// Forces value to be materialised, so the work producing it is kept
+template <typename T>
+inline void
+do_not_optimize( const T & value ) {
+    asm volatile( "" : : "r"( &value ) : "memory" );
+}
+
+class BenchState
+{
+    private:
+    using clock = std::chrono::steady_clock;
+
+    std::uint64_t     m_iterations;
+    std::uint64_t     m_remaining;
+    bool              m_started{ false };
+    clock::time_point m_start_real{};
+    clock::time_point m_end_real{};
+    std::clock_t      m_start_cpu{};
+    std::clock_t      m_end_cpu{};
+    std::uint64_t     m_bytes_per_iteration{ 0 };
+    std::uint64_t     m_items_per_iteration{ 0 };
+
+    public:
+    BenchState() = delete;
+    explicit BenchState( const std::uint64_t iterations ) :
+        m_iterations( iterations ), m_remaining( iterations ) {}
+
+    [[nodiscard]] bool keep_running() {
+        if ( !m_started ) {
+            m_started = true;
+            m_start_cpu = std::clock();
+            m_start_real = clock::now();
+        }
+        if ( m_remaining == 0 ) {
+            m_end_real = clock::now();
+            m_end_cpu = std::clock();
+            return false;
+        }
+        --m_remaining;
+        return true;
+    }
+
+    void set_bytes_processed( const std::uint64_t bytes ) noexcept {
+        m_bytes_per_iteration = bytes;
+    }
+    void set_items_processed( const std::uint64_t items ) noexcept {
+        m_items_per_iteration = items;
+    }
+
+    [[nodiscard]] auto iterations() const noexcept { return m_iterations; }
+    [[nodiscard]] auto bytes_processed() const noexcept {
+        return m_bytes_per_iteration;
+    }
+    [[nodiscard]] auto items_processed() const noexcept {
+        return m_items_per_iteration;
+    }
+    [[nodiscard]] double real_seconds() const noexcept {
+        return std::chrono::duration<double>( m_end_real - m_start_real )
+            .count();
+    }
+    [[nodiscard]] double cpu_seconds() const noexcept {
+        return static_cast<double>( m_end_cpu - m_start_cpu )
+               / static_cast<double>( CLOCKS_PER_SEC );
+    }
+};
+
+struct BenchResult
+{
+    std::string   name;
+    std::uint64_t iterations;
+    double        real_time_ns;
+    double        cpu_time_ns;
+    double        bytes_per_second;
+    double        items_per_second;
+};
+
+struct BenchOptions
+{
+    std::string              filter{};
+    double                   min_time{ 0.5 };
+    std::filesystem::path    json_path{ "bench.json" };
+    std::vector<std::string> unparsed{};
+};
+
+// Understands --filter=<substring>, --min_time=<seconds> and
+// --json=<path>, anything else is left for the caller.
+inline BenchOptions
+parse_bench_args( const int argc, const char * const * argv ) {
+    BenchOptions options{};
+    for ( int i{ 1 }; i < argc; ++i ) {
+        const std::string_view arg{ argv[i] };
+        if ( arg.starts_with( "--filter=" ) )
+            options.filter = arg.substr( 9 );
+        else if ( arg.starts_with( "--min_time=" ) )
+            options.min_time = std::stod( std::string{ arg.substr( 11 ) } );
+        else if ( arg.starts_with( "--json=" ) )
+            options.json_path = arg.substr( 7 );
+        else
+            options.unparsed.emplace_back( arg );
+    }
+    return options;
+}
+
+class BenchSuite
+{
+    private:
+    using bench_function = std::function<void( BenchState & )>;
+
+    std::vector<std::pair<std::string, bench_function>> m_benchmarks{};
+    std::vector<std::pair<std::string, std::string>>    m_context{};
+
+    static constexpr std::uint64_t max_iterations{ 1'000'000'000 };
+
+    static BenchResult run_one( const std::string &    name,
+                                const bench_function & function,
+                                const double           min_time ) {
+        std::uint64_t iterations{ 1 };
+        while ( true ) {
+            BenchState state{ iterations };
+            function( state );
+
+            const auto elapsed{ state.real_seconds() };
+            if ( elapsed >= min_time || iterations >= max_iterations ) {
+                const auto n{ static_cast<double>( iterations ) };
+                const auto per_second = [&]( const std::uint64_t amount ) {
+                    return elapsed > 0 ?
+                               static_cast<double>( amount ) * n / elapsed :
+                               0.0;
+                };
+                return BenchResult{ name,
+                                    iterations,
+                                    elapsed * 1e9 / n,
+                                    state.cpu_seconds() * 1e9 / n,
+                                    per_second( state.bytes_processed() ),
+                                    per_second( state.items_processed() ) };
+            }
+
+            // Aim 40% past min_time, growing by at most 10x per attempt
+            const auto target{ elapsed > 0 ? min_time * 1.4 / elapsed
+                                                 * static_cast<double>(
+                                                     iterations ) :
+                                             static_cast<double>(
+                                                 iterations * 10 ) };
+            iterations = std::clamp(
+                static_cast<std::uint64_t>( target ),
+                iterations + 1,
+                std::min( iterations * 10, max_iterations ) );
+        }
+    }
+
+    static std::string json_escape( const std::string_view text ) {
+        std::string escaped{};
+        for ( const char c : text ) {
+            if ( c == '"' || c == '\\' )
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    public:
+    void add( std::string name, bench_function function ) {
+        m_benchmarks.emplace_back( std::move( name ), std::move( function ) );
+    }
+    void add_context( std::string key, std::string value ) {
+        m_context.emplace_back( std::move( key ), std::move( value ) );
+    }
+
+    std::vector<BenchResult> run( const BenchOptions & options ) const {
+        std::vector<BenchResult> results{};
+
+        std::println( "{:<48} {:>16} {:>16} {:>12} {:>14}",
+                      "Benchmark",
+                      "Time (ns)",
+                      "CPU (ns)",
+                      "Iterations",
+                      "Throughput" );
+        std::println( "{}", std::string( 110, '-' ) );
+
+        for ( const auto & [name, function] : m_benchmarks ) {
+            if ( !options.filter.empty()
+                 && name.find( options.filter ) == std::string::npos )
+                continue;
+
+            const auto & result{ results.emplace_back(
+                run_one( name, function, options.min_time ) ) };
+
+            std::string throughput{};
+            if ( result.bytes_per_second > 0 )
+                throughput =
+                    std::format( "{:.1f} MiB/s",
+                                 result.bytes_per_second / ( 1 << 20 ) );
+            else if ( result.items_per_second > 0 )
+                throughput =
+                    std::format( "{:.2f} M/s", result.items_per_second / 1e6 );
+
+            std::println( "{:<48} {:>16.0f} {:>16.0f} {:>12} {:>14}",
+                          result.name,
+                          result.real_time_ns,
+                          result.cpu_time_ns,
+                          result.iterations,
+                          throughput );
+        }
+
+        return results;
+    }
+
+    void write_json( const std::vector<BenchResult> & results,
+                     const std::filesystem::path &    path ) const {
+        std::ofstream out( path );
+        if ( !out.is_open() ) {
+            std::cerr << std::format( "Unable to open file {}.",
+                                      path.string() )
+                      << std::endl;
+            return;
+        }
+
+        out << "{\n  \"context\": {\n";
+        out << std::format( "    \"num_cpus\": {}",
+                            std::thread::hardware_concurrency() );
+        for ( const auto & [key, value] : m_context ) {
+            out << std::format( ",\n    \"{}\": \"{}\"",
+                                json_escape( key ),
+                                json_escape( value ) );
+        }
+        out << "\n  },\n  \"benchmarks\": [";
+
+        for ( std::size_t i{ 0 }; i < results.size(); ++i ) {
+            const auto & result{ results[i] };
+            out << ( i == 0 ? "\n" : ",\n" );
+            out << std::format( "    {{\n"
+                                "      \"name\": \"{}\",\n"
+                                "      \"run_type\": \"iteration\",\n"
+                                "      \"iterations\": {},\n"
+                                "      \"real_time\": {},\n"
+                                "      \"cpu_time\": {},\n"
+                                "      \"time_unit\": \"ns\",\n"
+                                "      \"bytes_per_second\": {},\n"
+                                "      \"items_per_second\": {}\n"
+                                "    }}",
+                                json_escape( result.name ),
+                                result.iterations,
+                                result.real_time_ns,
+                                result.cpu_time_ns,
+                                result.bytes_per_second,
+                                result.items_per_second );
+        }
+        out << "\n  ]\n}\n";
+    }
+};
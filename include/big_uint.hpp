@@ -0,0 +1,145 @@
+#pragma once
+
+#include "numeric.hpp"
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <ostream>
+#include <string>
+
+/*
+ * Fixed-width unsigned integer of Limbs 64-bit limbs.
+ *  - Limbs are stored least significant first in a std::array, so values
+ *    live wherever the BigUInt does and nothing allocates.
+ *  - Only the operations the solvers need are provided: appending a
+ *    decimal digit, addition and comparison. Arithmetic wraps modulo
+ *    2^(64 * Limbs) like the built-in unsigned types, size Limbs with
+ *    digits_to_limbs.
+ *  - Printing converts 19 decimal digits at a time.
+ */
+
+// Limbs needed for any value of the given number of decimal digits
+[[nodiscard]] constexpr std::size_t
+digits_to_limbs( const std::size_t digits ) noexcept {
+    // log2(10) < 3.3220, rounded up
+    const auto bits{ ( digits * 33220 + 9999 ) / 10000 };
+    return std::max( ( bits + 63 ) / 64, std::size_t{ 1 } );
+}
+
+template <std::size_t Limbs>
+    requires( Limbs > 0 )
+class BigUInt
+{
+    private:
+    std::array<std::uint64_t, Limbs> m_limbs{};
+
+    // Divides in place by divisor, returns the remainder
+    constexpr std::uint64_t divide( const std::uint64_t divisor ) noexcept {
+        uint128 remainder{ 0 };
+        for ( auto i{ Limbs }; i > 0; --i ) {
+            const auto dividend{ ( remainder << 64 ) | m_limbs[i - 1] };
+            m_limbs[i - 1] = static_cast<std::uint64_t>( dividend / divisor );
+            remainder = dividend % divisor;
+        }
+        return static_cast<std::uint64_t>( remainder );
+    }
+
+    public:
+    constexpr BigUInt() noexcept = default;
+    constexpr BigUInt( const std::uint64_t value ) noexcept :
+        m_limbs{ value } {}
+
+    constexpr BigUInt( const BigUInt & ) noexcept = default;
+    constexpr BigUInt( BigUInt && ) noexcept = default;
+
+    constexpr BigUInt & operator=( const BigUInt & ) noexcept = default;
+    constexpr BigUInt & operator=( BigUInt && ) noexcept = default;
+
+    constexpr ~BigUInt() = default;
+
+    [[nodiscard]] constexpr const auto & limbs() const noexcept {
+        return m_limbs;
+    }
+
+    [[nodiscard]] constexpr bool is_zero() const noexcept {
+        return std::ranges::all_of(
+            m_limbs, []( const auto limb ) { return limb == 0; } );
+    }
+
+    // *this = *this * 10 + digit
+    constexpr BigUInt & append_digit( const std::uint8_t digit ) noexcept {
+        std::uint64_t carry{ digit };
+        for ( auto & limb : m_limbs ) {
+            const auto product{ uint128{ limb } * 10 + carry };
+            limb = static_cast<std::uint64_t>( product );
+            carry = static_cast<std::uint64_t>( product >> 64 );
+        }
+        return *this;
+    }
+
+    constexpr BigUInt & operator+=( const BigUInt & other ) noexcept {
+        std::uint64_t carry{ 0 };
+        for ( std::size_t i{ 0 }; i < Limbs; ++i ) {
+            const auto sum{ uint128{ m_limbs[i] } + other.m_limbs[i]
+                            + carry };
+            m_limbs[i] = static_cast<std::uint64_t>( sum );
+            carry = static_cast<std::uint64_t>( sum >> 64 );
+        }
+        return *this;
+    }
+
+    [[nodiscard]] friend constexpr BigUInt
+    operator+( BigUInt left, const BigUInt & right ) noexcept {
+        return left += right;
+    }
+
+    [[nodiscard]] friend constexpr bool
+    operator==( const BigUInt &, const BigUInt & ) noexcept = default;
+
+    [[nodiscard]] friend constexpr std::strong_ordering
+    operator<=>( const BigUInt & left, const BigUInt & right ) noexcept {
+        for ( auto i{ Limbs }; i > 0; --i ) {
+            if ( left.m_limbs[i - 1] != right.m_limbs[i - 1] )
+                return left.m_limbs[i - 1] <=> right.m_limbs[i - 1];
+        }
+        return std::strong_ordering::equal;
+    }
+
+    [[nodiscard]] std::string to_string() const {
+        // Chunks of 19 digits, least significant first
+        std::array<std::uint64_t, ( Limbs * 64 + 18 ) / 19 + 1> chunks{};
+        std::size_t n_chunks{ 0 };
+
+        auto rest{ *this };
+        do {
+            chunks[n_chunks++] = rest.divide( pow10( 19 ) );
+        } while ( !rest.is_zero() );
+
+        auto text{ std::to_string( chunks[n_chunks - 1] ) };
+        for ( auto i{ n_chunks - 1 }; i > 0; --i ) {
+            text += std::format( "{:019}", chunks[i - 1] );
+        }
+        return text;
+    }
+};
+
+template <std::size_t Limbs>
+struct std::formatter<BigUInt<Limbs>, char> : std::formatter<std::string, char>
+{
+    template <class FmtContext>
+    FmtContext::iterator format( const BigUInt<Limbs> & value,
+                                 FmtContext &            ctx ) const {
+        return std::formatter<std::string, char>::format( value.to_string(),
+                                                          ctx );
+    }
+};
+
+template <std::size_t Limbs>
+std::ostream &
+operator<<( std::ostream & os, const BigUInt<Limbs> & value ) {
+    return os << value.to_string();
+}
@@ -2,7 +2,13 @@
 
 #include <filesystem>
 
+// Builds define AOC_PROJECT_ROOT as the source directory, so inputs are
+// found wherever the repository is checked out.
+#ifdef AOC_PROJECT_ROOT
+static const std::filesystem::path project_root{ AOC_PROJECT_ROOT };
+#else
 static const std::filesystem::path project_root{
     "/Users/benand01/Library/CloudStorage/OneDrive-Arm/Documents/repositories/"
     "AOC2025"
 };
+#endif
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "scan.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/*
+ * Decimal digit kernels.
+ *  - decode_digits turns ASCII digits into their values, one byte each.
+ *  - first_max_index finds the first occurrence of the largest byte in
+ *    a block, stopping early at the first byte equal to a known ceiling
+ *    (nothing can beat '9').
+ *  - AVX2 kernels work on 32 bytes per instruction, the scalar fallbacks
+ *    decode 8 bytes per word and search byte by byte. The kernel is picked
+ *    with the same runtime detection as the delimiter scanners.
+ */
+
+namespace detail
+{
+
+inline void
+decode_digits_scalar( const char * data, const std::size_t size,
+                      std::uint8_t * out, std::size_t i = 0 ) noexcept {
+    // Digits are at least '0', so no byte borrows from its neighbour
+    constexpr std::uint64_t zeros{ 0x3030303030303030ULL };
+    for ( ; i + 8 <= size; i += 8 ) {
+        std::uint64_t word;
+        std::memcpy( &word, data + i, sizeof( word ) );
+        word -= zeros;
+        std::memcpy( out + i, &word, sizeof( word ) );
+    }
+    for ( ; i < size; ++i ) {
+        out[i] = static_cast<std::uint8_t>( data[i] - '0' );
+    }
+}
+
+[[nodiscard]] inline std::size_t
+first_max_index_scalar( const char * data, const std::size_t size,
+                        const char ceiling ) noexcept {
+    std::size_t index{ 0 };
+    for ( std::size_t i{ 1 }; i < size && data[index] != ceiling; ++i ) {
+        if ( static_cast<unsigned char>( data[i] )
+             > static_cast<unsigned char>( data[index] ) )
+            index = i;
+    }
+    return index;
+}
+
+#ifdef AOC_X86_SIMD
+
+[[gnu::target( "avx2" )]] inline void
+decode_digits_avx2( const char * data, const std::size_t size,
+                    std::uint8_t * out ) noexcept {
+    const auto  zeros{ _mm256_set1_epi8( '0' ) };
+    std::size_t i{ 0 };
+    for ( ; i + 32 <= size; i += 32 ) {
+        const auto block{ _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>( data + i ) ) };
+        _mm256_storeu_si256( reinterpret_cast<__m256i *>( out + i ),
+                             _mm256_sub_epi8( block, zeros ) );
+    }
+    decode_digits_scalar( data, size, out, i );
+}
+
+// Bit per byte of the 32 bytes at data equal to value
+[[gnu::target( "avx2" )]] inline std::uint32_t
+equal_mask_avx2( const char * data, const char value ) noexcept {
+    const auto block{ _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>( data ) ) };
+    return static_cast<std::uint32_t>( _mm256_movemask_epi8(
+        _mm256_cmpeq_epi8( block, _mm256_set1_epi8( value ) ) ) );
+}
+
+/*
+ * First pass: running unsigned byte maximum over 32 byte blocks (the tail
+ * is an overlapping last block), returning straight away from the first
+ * block that holds the ceiling. Second pass: first block equal to the
+ * horizontal maximum.
+ */
+[[gnu::target( "avx2" )]] inline std::size_t
+first_max_index_avx2( const char * data, const std::size_t size,
+                      const char ceiling ) noexcept {
+    if ( size < 32 )
+        return first_max_index_scalar( data, size, ceiling );
+
+    const auto last_block{ size - 32 };
+    auto       maximum{ _mm256_setzero_si256() };
+    for ( std::size_t i{ 0 };; i = std::min( i + 32, last_block ) ) {
+        if ( const auto mask{ equal_mask_avx2( data + i, ceiling ) } )
+            return i + static_cast<std::size_t>( std::countr_zero( mask ) );
+
+        maximum = _mm256_max_epu8(
+            maximum,
+            _mm256_loadu_si256( reinterpret_cast<const __m256i *>( data + i ) ) );
+        if ( i == last_block )
+            break;
+    }
+
+    auto reduced{ _mm_max_epu8( _mm256_castsi256_si128( maximum ),
+                                _mm256_extracti128_si256( maximum, 1 ) ) };
+    reduced = _mm_max_epu8( reduced, _mm_srli_si128( reduced, 8 ) );
+    reduced = _mm_max_epu8( reduced, _mm_srli_si128( reduced, 4 ) );
+    reduced = _mm_max_epu8( reduced, _mm_srli_si128( reduced, 2 ) );
+    reduced = _mm_max_epu8( reduced, _mm_srli_si128( reduced, 1 ) );
+    const auto max_byte{ static_cast<char>( _mm_cvtsi128_si32( reduced ) ) };
+
+    for ( std::size_t i{ 0 };; i = std::min( i + 32, last_block ) ) {
+        if ( const auto mask{ equal_mask_avx2( data + i, max_byte ) } )
+            return i + static_cast<std::size_t>( std::countr_zero( mask ) );
+    }
+}
+
+#endif // AOC_X86_SIMD
+
+} // namespace detail
+
+// out[i] = data[i] - '0', data must only hold '0' ... '9'
+inline void
+decode_digits( const char * data, const std::size_t size, std::uint8_t * out,
+               const ScanIsa isa = scan_isa() ) noexcept {
+#ifdef AOC_X86_SIMD
+    if ( isa == ScanIsa::AVX2 )
+        return detail::decode_digits_avx2( data, size, out );
+#endif
+    detail::decode_digits_scalar( data, size, out );
+}
+
+// Index of the first largest byte of data[0, size), size must not be 0.
+// Any byte equal to ceiling is taken as the largest.
+[[nodiscard]] inline std::size_t
+first_max_index( const char * data, const std::size_t size,
+                 const char ceiling = '9',
+                 const ScanIsa isa = scan_isa() ) noexcept {
+    assert( size > 0 );
+#ifdef AOC_X86_SIMD
+    if ( isa == ScanIsa::AVX2 )
+        return detail::first_max_index_avx2( data, size, ceiling );
+#endif
+    return detail::first_max_index_scalar( data, size, ceiling );
+}
@@ -1,82 +1,400 @@
 #pragma once
 
 #include "constants.hpp"
+#include "parse.hpp"
+#include "scan.hpp"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <concepts>
+#include <cstring>
+#include <iterator>
 #include <exception>
 #include <filesystem>
 #include <format>
-#include <fstream>
 #include <iostream>
 #include <print>
 #include <ranges>
-#include <regex>
 #include <sstream>
 #include <string_view>
+#include <utility>
 #include <vector>
 
-constexpr std::string
+/*
+ * Read-only view over the contents of an input file.
+ *  - Regular files are mapped straight from the page cache, so any
+ *    std::string_view taken from the input points at the mapping and
+ *    nothing is copied or allocated up front.
+ *  - Anything that cannot be mapped (pipes, character devices, empty
+ *    files) falls back to buffered reads into an owned string.
+ */
+class InputFile
+{
+    private:
+    const char * m_mapping{ nullptr };
+    std::size_t  m_mapping_size{ 0 };
+    std::string  m_buffer{};
+    bool         m_failed{ false };
+
+    static constexpr std::size_t read_chunk_size{ 1 << 16 };
+
+    void release() noexcept {
+        if ( m_mapping != nullptr )
+            munmap( const_cast<char *>( m_mapping ), m_mapping_size );
+        m_mapping = nullptr;
+        m_mapping_size = 0;
+        m_buffer.clear();
+    }
+
+    bool map_file( const int fd, const std::size_t file_size ) {
+        void * const mapping{
+            mmap( nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0 )
+        };
+        if ( mapping == MAP_FAILED )
+            return false;
+
+        // Solvers walk the input front to back exactly once
+        madvise( mapping, file_size, MADV_SEQUENTIAL );
+
+        m_mapping = static_cast<const char *>( mapping );
+        m_mapping_size = file_size;
+        return true;
+    }
+
+    bool buffer_file( const int fd ) {
+        std::size_t used{ 0 };
+        while ( true ) {
+            m_buffer.resize( used + read_chunk_size );
+            const auto n_read{ read( fd, m_buffer.data() + used,
+                                     read_chunk_size ) };
+            if ( n_read < 0 ) {
+                if ( errno == EINTR )
+                    continue;
+                m_buffer.clear();
+                return false;
+            }
+            if ( n_read == 0 )
+                break;
+            used += static_cast<std::size_t>( n_read );
+        }
+        m_buffer.resize( used );
+        return true;
+    }
+
+    public:
+    InputFile() = default;
+    explicit InputFile( const std::filesystem::path & path ) {
+        const int fd{ open( path.c_str(), O_RDONLY ) };
+        if ( fd < 0 ) {
+            std::cerr << std::format( "Unable to open file {}.",
+                                      path.string() )
+                      << std::endl;
+            m_failed = true;
+            return;
+        }
+
+        struct stat file_stat{};
+        const bool  is_regular{ fstat( fd, &file_stat ) == 0
+                               && S_ISREG( file_stat.st_mode ) };
+        const auto  file_size{ static_cast<std::size_t>( file_stat.st_size ) };
+
+        if ( !( is_regular && file_size > 0 && map_file( fd, file_size ) )
+             && !buffer_file( fd ) ) {
+            std::cerr << std::format( "Unable to read file {}.",
+                                      path.string() )
+                      << std::endl;
+            m_failed = true;
+        }
+
+        close( fd );
+    }
+
+    InputFile( const InputFile & ) = delete;
+    InputFile( InputFile && other ) noexcept :
+        m_mapping( std::exchange( other.m_mapping, nullptr ) ),
+        m_mapping_size( std::exchange( other.m_mapping_size, 0 ) ),
+        m_buffer( std::move( other.m_buffer ) ),
+        m_failed( other.m_failed ) {}
+
+    InputFile & operator=( const InputFile & ) = delete;
+    InputFile & operator=( InputFile && other ) noexcept {
+        if ( this != &other ) {
+            release();
+            m_mapping = std::exchange( other.m_mapping, nullptr );
+            m_mapping_size = std::exchange( other.m_mapping_size, 0 );
+            m_buffer = std::move( other.m_buffer );
+            m_failed = other.m_failed;
+        }
+        return *this;
+    }
+
+    ~InputFile() { release(); }
+
+    [[nodiscard]] std::string_view view() const noexcept {
+        return m_mapping != nullptr ?
+                   std::string_view{ m_mapping, m_mapping_size } :
+                   std::string_view{ m_buffer };
+    }
+    [[nodiscard]] auto size() const noexcept { return view().size(); }
+    [[nodiscard]] auto empty() const noexcept { return view().empty(); }
+    [[nodiscard]] auto is_mapped() const noexcept {
+        return m_mapping != nullptr;
+    }
+    // Whether the file could not be opened or read, the view is then empty
+    [[nodiscard]] bool failed() const noexcept { return m_failed; }
+
+    operator std::string_view() const noexcept { return view(); }
+};
+
+inline InputFile
 read_file( const std::filesystem::directory_entry & file_obj ) {
     // Check file exists
     if ( !file_obj.exists() ) {
         std::cerr << std::format( "File {} does not exist.",
                                   file_obj.path().string() )
                   << std::endl;
-        return "";
+        return InputFile{};
     }
 
-    // Open file
-    std::ifstream file_stream( file_obj.path() );
-    if ( !file_stream.is_open() ) {
-        std::cerr << std::format( "Unable to open file {}.",
-                                  file_obj.path().string() )
-                  << std::endl;
-        return "";
-    }
-
-    // Get length of file
-    file_stream.seekg( 0, std::ios_base::end );
-    const auto file_size{ static_cast<std::size_t>( file_stream.tellg() ) };
-    file_stream.seekg( std::ios_base::beg );
-    file_stream.clear();
-
-    // Initialise string to store file
-    std::string result( file_size, '\0' );
-    file_stream.read( result.data(), result.size() );
+    return InputFile{ file_obj.path() };
+}
 
-    return result;
+inline std::filesystem::path
+input_file_path( const std::uint32_t day_no ) {
+    return project_root / ( "day" + std::to_string( day_no ) ) / "input.txt";
 }
 
-constexpr std::string
+inline InputFile
 get_input_file( const std::uint32_t day_no ) {
-    const auto input_file_path{
-        project_root / ( "day" + std::to_string( day_no ) ) / "input.txt"
-    };
-    return read_file( std::filesystem::directory_entry( input_file_path ) );
+    return read_file(
+        std::filesystem::directory_entry( input_file_path( day_no ) ) );
 }
 
 constexpr std::vector<std::string_view>
 split_input( const std::string_view file,
              const std::string_view delim = "\n" ) {
+    // Single byte delimiters go through the vectorised scanner
+    if !consteval {
+        if ( delim.size() == 1 )
+            return split_delimited( file, delim.front() );
+    }
+
     return file | std::views::split( delim )
            | std::views::transform( []( auto && rng ) {
-                 return std::string_view( &*rng.cbegin(),
-                                          std::ranges::distance( rng ) );
+                 // Not &*begin, empty records may sit at the end of file
+                 return std::string_view( rng.begin(), rng.end() );
              } )
            | std::ranges::to<std::vector<std::string_view>>();
 }
 
-constexpr std::vector<std::string_view>
-sanitize_input( const std::vector<std::string_view> & inputs,
-                const std::regex &                    pattern ) {
-    const auto filter_func = [&pattern]( const auto view ) {
-        std::smatch       result;
-        const std::string tmp{ view.data(), view.size() };
-        return std::regex_match( tmp.cbegin(), tmp.cend(), result, pattern );
+// Any range of records (lines, comma separated fields, ...) a solver
+// can consume, e.g. the output of split_input or a RecordStream.
+template <typename R>
+concept record_range =
+    std::ranges::input_range<R>
+    && std::convertible_to<std::ranges::range_reference_t<R>,
+                           std::string_view>;
+
+/*
+ * Streams delimiter separated records from a file in fixed-size chunks.
+ *  - Memory use is bounded by the chunk size (or the longest record, if
+ *    a single record does not fit in one chunk).
+ *  - Records which cross a chunk boundary are carried over into the
+ *    next chunk before being handed out.
+ *  - Records match split_input: empty input yields nothing, and a
+ *    trailing delimiter yields a trailing empty record.
+ *  - A record view is only valid until the stream is advanced.
+ *  - A failed read is reported on stderr and ends the stream, it is never
+ *    taken for the end of the file.
+ */
+class RecordStream
+{
+    private:
+    std::filesystem::path m_path{};
+    int                   m_fd{ -1 };
+    char                  m_delim{ '\n' };
+    std::vector<char>     m_buffer{};
+    std::size_t           m_begin{ 0 };
+    std::size_t           m_end{ 0 };
+    std::size_t           m_scanned{ 0 };
+    std::size_t           m_total_read{ 0 };
+    bool                  m_eof{ false };
+    bool                  m_done{ false };
+    bool                  m_failed{ false };
+
+    // Moves the unconsumed tail to the front of the buffer and reads the
+    // next chunk after it, growing the buffer only if the tail fills it.
+    void read_chunk() {
+        if ( m_begin > 0 ) {
+            std::memmove( m_buffer.data(),
+                          m_buffer.data() + m_begin,
+                          m_end - m_begin );
+            m_end -= m_begin;
+            m_begin = 0;
+        }
+        if ( m_end == m_buffer.size() )
+            m_buffer.resize( m_buffer.size() * 2 );
+
+        while ( true ) {
+            const auto n_read{ read(
+                m_fd, m_buffer.data() + m_end, m_buffer.size() - m_end ) };
+            if ( n_read < 0 ) {
+                if ( errno == EINTR )
+                    continue;
+                // Handing out what was read so far would pass a truncated
+                // input off as a whole one
+                std::cerr << std::format( "Unable to read file {}: {}.",
+                                          m_path.string(),
+                                          std::strerror( errno ) )
+                          << std::endl;
+                m_failed = true;
+                m_done = true;
+                return;
+            }
+            if ( n_read == 0 ) {
+                m_eof = true;
+                return;
+            }
+            m_end += static_cast<std::size_t>( n_read );
+            m_total_read += static_cast<std::size_t>( n_read );
+            return;
+        }
+    }
+
+    public:
+    static constexpr std::size_t default_chunk_size{ 1 << 16 };
+
+    class iterator
+    {
+        private:
+        RecordStream *   m_stream{ nullptr };
+        std::string_view m_record{};
+
+        public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator( RecordStream & stream ) : m_stream( &stream ) {
+            ++*this;
+        }
+
+        [[nodiscard]] std::string_view operator*() const noexcept {
+            return m_record;
+        }
+        iterator & operator++() {
+            if ( m_stream != nullptr && !m_stream->next( m_record ) )
+                m_stream = nullptr;
+            return *this;
+        }
+        void operator++( int ) { ++*this; }
+
+        [[nodiscard]] friend bool operator==( const iterator & it,
+                                              std::default_sentinel_t ) {
+            return it.m_stream == nullptr;
+        }
     };
-    return inputs | std::views::filter( filter_func )
-           | std::views::transform( []( auto && rng ) {
-                 return std::string_view( &*rng.cbegin(),
-                                          std::ranges::distance( rng ) );
+
+    RecordStream() = delete;
+    explicit RecordStream( const std::filesystem::path & path,
+                           const char                    delim = '\n',
+                           const std::size_t chunk_size = default_chunk_size ) :
+        m_path( path ),
+        m_fd( open( path.c_str(), O_RDONLY ) ),
+        m_delim( delim ),
+        m_buffer( std::max( chunk_size, std::size_t{ 1 } ) ) {
+        if ( m_fd < 0 ) {
+            std::cerr << std::format( "Unable to open file {}.",
+                                      path.string() )
+                      << std::endl;
+            m_done = true;
+            m_failed = true;
+            return;
+        }
+        posix_fadvise( m_fd, 0, 0, POSIX_FADV_SEQUENTIAL );
+    }
+
+    RecordStream( const RecordStream & ) = delete;
+    RecordStream( RecordStream && other ) noexcept :
+        m_path( std::move( other.m_path ) ),
+        m_fd( std::exchange( other.m_fd, -1 ) ),
+        m_delim( other.m_delim ),
+        m_buffer( std::move( other.m_buffer ) ),
+        m_begin( other.m_begin ),
+        m_end( other.m_end ),
+        m_scanned( other.m_scanned ),
+        m_total_read( other.m_total_read ),
+        m_eof( other.m_eof ),
+        m_done( std::exchange( other.m_done, true ) ),
+        m_failed( other.m_failed ) {}
+
+    RecordStream & operator=( const RecordStream & ) = delete;
+    RecordStream & operator=( RecordStream && ) = delete;
+
+    ~RecordStream() {
+        if ( m_fd >= 0 )
+            close( m_fd );
+    }
+
+    // Reads the next record, returning false once the stream is exhausted
+    bool next( std::string_view & record ) {
+        while ( !m_done ) {
+            const char * const start{ m_buffer.data() + m_begin };
+            const auto         available{ m_end - m_begin };
+
+            const auto * const delim{ static_cast<const char *>( std::memchr(
+                start + m_scanned, m_delim, available - m_scanned ) ) };
+            if ( delim != nullptr ) {
+                const auto length{ static_cast<std::size_t>( delim - start ) };
+                record = std::string_view{ start, length };
+                m_begin += length + 1;
+                m_scanned = 0;
+                return true;
+            }
+            m_scanned = available;
+
+            if ( m_eof ) {
+                // Whatever follows the last delimiter is the final record
+                m_done = true;
+                if ( m_total_read == 0 )
+                    return false;
+                record = std::string_view{ start, available };
+                m_begin = m_end;
+                return true;
+            }
+
+            read_chunk();
+        }
+        return false;
+    }
+
+    // Whether the file could not be opened or a read failed, the records
+    // handed out are then not the whole input
+    [[nodiscard]] bool failed() const noexcept { return m_failed; }
+
+    [[nodiscard]] iterator begin() { return iterator{ *this }; }
+    [[nodiscard]] std::default_sentinel_t end() const noexcept {
+        return std::default_sentinel;
+    }
+};
+
+inline RecordStream
+stream_input_file( const std::uint32_t day_no, const char delim = '\n' ) {
+    return RecordStream{ input_file_path( day_no ), delim };
+}
+
+// Keeps only the inputs which the parser matches in full
+template <parse::parser P>
+constexpr std::vector<std::string_view>
+sanitize_input( const std::vector<std::string_view> & inputs ) {
+    return inputs
+           | std::views::filter( []( const std::string_view view ) {
+                 return parse::matches<P>( view );
              } )
            | std::ranges::to<std::vector<std::string_view>>();
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "numeric.hpp"
+#include "parse.hpp"
+
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Shared plumbing for the dayN_generate synthetic input tools (and other
+ * small input tools, e.g. day1_convert).
+ *  - Arguments are --key=value pairs, e.g. --count=1000000 --seed=7.
+ *  - Output goes to stdout, or to --output=<path>, and is streamed so
+ *    inputs of any size are produced in constant memory.
+ *  - Randomness comes from std::mt19937_64 (fully specified by the
+ *    standard) mapped to ranges by hand, since the std distributions
+ *    are implementation defined. A seed gives the same input on every
+ *    platform.
+ */
+
+inline constexpr std::uint64_t default_generator_seed{ 2025 };
+
+// Uniform value in [0, bound) via a 128-bit multiply-shift
+inline std::uint64_t
+uniform_below( std::mt19937_64 & rng, const std::uint64_t bound ) {
+    return static_cast<std::uint64_t>(
+        ( static_cast<uint128>( rng() ) * bound ) >> 64 );
+}
+
+// Uniform value in [low, high]
+inline std::uint64_t
+uniform_between( std::mt19937_64 & rng, const std::uint64_t low,
+                 const std::uint64_t high ) {
+    return low + uniform_below( rng, high - low + 1 );
+}
+
+class GeneratorArgs
+{
+    private:
+    std::vector<std::pair<std::string, std::string>> m_args{};
+
+    [[nodiscard]] const std::string * find( const std::string_view key ) const {
+        for ( const auto & [name, value] : m_args ) {
+            if ( name == key )
+                return &value;
+        }
+        return nullptr;
+    }
+
+    public:
+    GeneratorArgs() = delete;
+    GeneratorArgs( const int argc, const char * const * argv ) {
+        for ( int i{ 1 }; i < argc; ++i ) {
+            std::string_view arg{ argv[i] };
+            if ( !arg.starts_with( "--" ) ) {
+                std::cerr << std::format( "Ignoring argument {}.", arg )
+                          << std::endl;
+                continue;
+            }
+            arg.remove_prefix( 2 );
+            const auto split{ arg.find( '=' ) };
+            m_args.emplace_back( arg.substr( 0, split ),
+                                 split == std::string_view::npos ?
+                                     std::string_view{} :
+                                     arg.substr( split + 1 ) );
+        }
+    }
+
+    [[nodiscard]] std::uint64_t get( const std::string_view key,
+                                     const std::uint64_t    fallback ) const {
+        const auto * const value{ find( key ) };
+        if ( value == nullptr )
+            return fallback;
+
+        const auto number{ parse::to_number<std::uint64_t>( *value ) };
+        if ( !number ) {
+            std::cerr << std::format(
+                "Invalid value {} for --{}, using {}.", *value, key, fallback )
+                      << std::endl;
+            return fallback;
+        }
+        return *number;
+    }
+
+    [[nodiscard]] std::string_view get( const std::string_view key,
+                                        const std::string_view fallback ) const {
+        const auto * const value{ find( key ) };
+        return value == nullptr ? fallback : std::string_view{ *value };
+    }
+
+    [[nodiscard]] std::uint64_t seed() const {
+        return get( "seed", default_generator_seed );
+    }
+
+    // Runs generator against the requested output, returning an exit code
+    int run( const std::function<void( std::ostream & )> & generator ) const {
+        const auto * const path{ find( "output" ) };
+        if ( path == nullptr ) {
+            std::ios::sync_with_stdio( false );
+            generator( std::cout );
+            std::cout.flush();
+            return std::cout.good() ? 0 : 1;
+        }
+
+        static constexpr std::size_t buffer_size{ 1 << 20 };
+        std::vector<char>            buffer( buffer_size );
+
+        std::ofstream out{};
+        out.rdbuf()->pubsetbuf( buffer.data(), buffer_size );
+        out.open( *path, std::ios::binary );
+        if ( !out.is_open() ) {
+            std::cerr << std::format( "Unable to open file {}.", *path )
+                      << std::endl;
+            return 1;
+        }
+        generator( out );
+        out.flush();
+        return out.good() ? 0 : 1;
+    }
+};
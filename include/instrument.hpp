@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Compile-time switchable instrumentation for solver hot paths.
+ *  - Define AOC_INSTRUMENT (cmake -DAOC_INSTRUMENT=ON) to turn it on.
+ *  - Off, Instrumented<T> is an empty type, to be stored with
+ *    [[no_unique_address]], and hooks passed to instrument are discarded,
+ *    so no counter, clock read or branch is left in the build.
+ *  - Clocks are never read during constant evaluation.
+ */
+
+#ifdef AOC_INSTRUMENT
+inline constexpr bool instrumented{ true };
+#else
+inline constexpr bool instrumented{ false };
+#endif
+
+struct NotInstrumented
+{};
+
+template <typename T>
+using Instrumented = std::conditional_t<instrumented, T, NotInstrumented>;
+
+using instrument_clock = std::chrono::steady_clock;
+
+// Calls hook( value ), only when instrumented. Write hooks as generic
+// lambdas, so their bodies are never checked against NotInstrumented.
+template <typename T, typename F>
+constexpr void
+instrument( T & value, F && hook ) noexcept {
+    if constexpr ( instrumented )
+        std::forward<F>( hook )( value );
+}
+
+// Start of a timed phase, nothing when not instrumented
+template <bool Enabled = instrumented>
+[[nodiscard]] constexpr std::conditional_t<Enabled, instrument_clock::time_point,
+                                           NotInstrumented>
+instrument_now() noexcept {
+    if constexpr ( Enabled ) {
+        if consteval {
+            return {};
+        } else {
+            return instrument_clock::now();
+        }
+    } else {
+        return {};
+    }
+}
+
+// Time since start, zero when not instrumented or during constant
+// evaluation
+template <typename TimePoint>
+[[nodiscard]] constexpr instrument_clock::duration
+instrument_elapsed( const TimePoint start ) noexcept {
+    if constexpr ( instrumented ) {
+        if consteval {
+            return {};
+        } else {
+            return instrument_clock::now() - start;
+        }
+    } else {
+        return {};
+    }
+}
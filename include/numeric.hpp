@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+
+/*
+ * Integer helpers shared by the solvers.
+ *  - Powers of ten come from a lookup table rather than std::pow, which
+ *    goes through double and loses precision above 2^53 (19 digit IDs).
+ *  - Digit counts use the bit width of the value to index the table
+ *    instead of dividing by ten once per digit.
+ */
+
+__extension__ typedef unsigned __int128 uint128;
+
+// 10^0 ... 10^19, every power of ten representable in a uint64_t
+inline constexpr auto pow10_table{ [] {
+    std::array<std::uint64_t, 20> table{};
+    std::uint64_t                 power{ 1 };
+    for ( auto & entry : table ) {
+        entry = power;
+        power *= 10;
+    }
+    return table;
+}() };
+
+[[nodiscard]] constexpr std::uint64_t
+pow10( const std::uint64_t exponent ) noexcept {
+    assert( exponent < pow10_table.size() );
+    return pow10_table[exponent];
+}
+
+// Powers of ten beyond uint64_t, up to 10^38
+[[nodiscard]] constexpr uint128
+pow10_wide( const std::uint64_t exponent ) noexcept {
+    assert( exponent < 39 );
+    if ( exponent < pow10_table.size() )
+        return pow10_table[exponent];
+    return pow10_wide( exponent - ( pow10_table.size() - 1 ) )
+           * pow10_table.back();
+}
+
+// Number of decimal digits in value, 0 for 0
+[[nodiscard]] constexpr std::uint64_t
+num_digits( const std::uint64_t value ) noexcept {
+    // bit_width * log10(2) (~1233 / 4096) is the digit count or one less
+    const auto bits{ static_cast<std::uint64_t>( std::bit_width( value ) ) };
+    const auto estimate{ ( bits * 1233 ) >> 12 };
+    return estimate + ( value >= pow10_table[estimate] );
+}
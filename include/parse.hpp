@@ -0,0 +1,172 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Minimal compile-time parser combinators.
+ *  - A parser is a type with a static constexpr parse(input) returning
+ *    the captured value and the unconsumed input, or std::nullopt.
+ *  - Parsers are composed as types, e.g.
+ *        sequence<choice<literal<'L'>, literal<'R'>>, digits>
+ *    so no parser objects are built at runtime and nothing allocates.
+ *  - Captures are views into the input, numbers are converted
+ *    separately with to_number.
+ */
+
+namespace parse
+{
+
+// std::isspace in the "C" locale, usable in constant expressions
+[[nodiscard]] constexpr bool
+is_space( const char c ) noexcept {
+    return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+template <typename T>
+struct Result
+{
+    T                value;
+    std::string_view rest;
+};
+
+template <typename P>
+concept parser = requires( const std::string_view input ) {
+    typename P::value_type;
+    {
+        P::parse( input )
+    } -> std::same_as<std::optional<Result<typename P::value_type>>>;
+};
+
+// Matches the single character C, capturing it
+template <char C>
+struct literal
+{
+    using value_type = char;
+
+    static constexpr std::optional<Result<value_type>>
+    parse( const std::string_view input ) noexcept {
+        if ( input.empty() || input.front() != C )
+            return std::nullopt;
+        return Result<value_type>{ C, input.substr( 1 ) };
+    }
+};
+
+// Matches a non-empty run of decimal digits, capturing the run
+struct digits
+{
+    using value_type = std::string_view;
+
+    static constexpr std::optional<Result<value_type>>
+    parse( const std::string_view input ) noexcept {
+        std::size_t length{ 0 };
+        while ( length < input.size() && input[length] >= '0'
+                && input[length] <= '9' ) {
+            ++length;
+        }
+        if ( length == 0 )
+            return std::nullopt;
+        return Result<value_type>{ input.substr( 0, length ),
+                                   input.substr( length ) };
+    }
+};
+
+// Tries each alternative in order, capturing the first match
+template <parser... Ps>
+    requires( sizeof...( Ps ) > 0 )
+struct choice
+{
+    using value_type = std::common_type_t<typename Ps::value_type...>;
+
+    static constexpr std::optional<Result<value_type>>
+    parse( const std::string_view input ) noexcept {
+        std::optional<Result<value_type>> result{};
+        [[maybe_unused]] const bool matched{ ( try_parse<Ps>( input, result )
+                                               || ... ) };
+        return result;
+    }
+
+    private:
+    template <parser P>
+    static constexpr bool
+    try_parse( const std::string_view                    input,
+               std::optional<Result<value_type>> & result ) noexcept {
+        if ( const auto match{ P::parse( input ) } ) {
+            result = Result<value_type>{ match->value, match->rest };
+            return true;
+        }
+        return false;
+    }
+};
+
+// Matches each parser in turn, capturing a tuple of their values
+template <parser... Ps>
+struct sequence
+{
+    using value_type = std::tuple<typename Ps::value_type...>;
+
+    static constexpr std::optional<Result<value_type>>
+    parse( std::string_view input ) noexcept {
+        value_type values{};
+        if ( !parse_all( input, values, std::index_sequence_for<Ps...>{} ) )
+            return std::nullopt;
+        return Result<value_type>{ values, input };
+    }
+
+    private:
+    template <std::size_t... Is>
+    static constexpr bool parse_all( std::string_view & input,
+                                     value_type &       values,
+                                     std::index_sequence<Is...> ) noexcept {
+        return ( parse_one<Is>( input, values ) && ... );
+    }
+
+    template <std::size_t I>
+    static constexpr bool parse_one( std::string_view & input,
+                                     value_type &       values ) noexcept {
+        using P = std::tuple_element_t<I, std::tuple<Ps...>>;
+        if ( const auto match{ P::parse( input ) } ) {
+            std::get<I>( values ) = match->value;
+            input = match->rest;
+            return true;
+        }
+        return false;
+    }
+};
+
+// Equivalent of std::regex_match: the parser must consume all of input
+template <parser P>
+constexpr std::optional<typename P::value_type>
+parse_full( const std::string_view input ) noexcept {
+    const auto result{ P::parse( input ) };
+    if ( !result || !result->rest.empty() )
+        return std::nullopt;
+    return result->value;
+}
+
+template <parser P>
+constexpr bool
+matches( const std::string_view input ) noexcept {
+    return parse_full<P>( input ).has_value();
+}
+
+// Converts a captured digit run, failing on overflow
+template <std::integral T>
+constexpr std::optional<T>
+to_number( const std::string_view digits ) noexcept {
+    T          value{};
+    const auto end{ digits.data() + digits.size() };
+    const auto [ptr, error]{ std::from_chars( digits.data(), end, value ) };
+    if ( error != std::errc{} || ptr != end )
+        return std::nullopt;
+    return value;
+}
+
+} // namespace parse
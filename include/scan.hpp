@@ -0,0 +1,249 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#define AOC_X86_SIMD 1
+#endif
+
+/*
+ * Single-byte delimiter scanning.
+ *  - Each kernel compares a block of input against the delimiter and
+ *    collapses the result into a bitmask (one bit per byte), so both
+ *    counting and locating delimiters work on whole blocks at a time.
+ *  - AVX2 and SSE4.2 kernels handle 64 bytes per iteration, the scalar
+ *    fallback handles 8 bytes per iteration with SWAR tricks.
+ *  - The kernel is picked once at runtime from the CPU's feature flags.
+ */
+
+enum class ScanIsa { Scalar, SSE42, AVX2 };
+
+namespace detail
+{
+
+// Sets the high bit of each byte in word equal to the broadcast pattern,
+// exactly (no false positives from borrows).
+[[nodiscard]] constexpr std::uint64_t
+swar_match( const std::uint64_t word, const std::uint64_t pattern ) noexcept {
+    constexpr std::uint64_t low_7_bits{ 0x7f7f7f7f7f7f7f7fULL };
+    const std::uint64_t     zeroed{ word ^ pattern };
+    return ~( ( ( zeroed & low_7_bits ) + low_7_bits ) | zeroed | low_7_bits );
+}
+
+[[nodiscard]] constexpr std::uint64_t
+broadcast( const char c ) noexcept {
+    return 0x0101010101010101ULL * static_cast<std::uint8_t>( c );
+}
+
+[[nodiscard]] inline std::uint64_t
+load_word( const char * data ) noexcept {
+    std::uint64_t word;
+    std::memcpy( &word, data, sizeof( word ) );
+    if constexpr ( std::endian::native == std::endian::big )
+        word = std::byteswap( word );
+    return word;
+}
+
+// Emits the piece ending at every set bit of mask (bit i -> data[base + i])
+struct SplitCursor
+{
+    const char *       piece_start;
+    std::string_view * out;
+
+    void emit( const char * data, std::size_t base, std::uint64_t mask,
+               const std::size_t stride ) noexcept {
+        while ( mask != 0 ) {
+            const auto bit{ static_cast<std::size_t>(
+                std::countr_zero( mask ) ) };
+            const char * delim{ data + base + bit / stride };
+            *out++ = std::string_view(
+                piece_start, static_cast<std::size_t>( delim - piece_start ) );
+            piece_start = delim + 1;
+            mask &= mask - 1;
+        }
+    }
+};
+
+[[nodiscard]] inline std::size_t
+count_scalar( const char * data, const std::size_t size, const char delim,
+              std::size_t i = 0 ) noexcept {
+    const auto  pattern{ broadcast( delim ) };
+    std::size_t count{ 0 };
+    for ( ; i + 8 <= size; i += 8 ) {
+        count += static_cast<std::size_t>(
+            std::popcount( swar_match( load_word( data + i ), pattern ) ) );
+    }
+    for ( ; i < size; ++i ) { count += data[i] == delim; }
+    return count;
+}
+
+inline void
+split_scalar( const char * data, const std::size_t size, const char delim,
+              SplitCursor & cursor, std::size_t i = 0 ) noexcept {
+    const auto pattern{ broadcast( delim ) };
+    for ( ; i + 8 <= size; i += 8 ) {
+        cursor.emit(
+            data, i, swar_match( load_word( data + i ), pattern ), 8 );
+    }
+    for ( ; i < size; ++i ) {
+        if ( data[i] == delim )
+            cursor.emit( data, i, 1, 1 );
+    }
+}
+
+#ifdef AOC_X86_SIMD
+
+// Kernels take the delimiter rather than a broadcast vector so that no
+// vector type crosses a function boundary outside its target region
+[[gnu::target( "sse4.2" )]] inline std::uint64_t
+block_mask_sse42( const char * data, const char delim ) noexcept {
+    const auto    pattern{ _mm_set1_epi8( delim ) };
+    std::uint64_t mask{ 0 };
+    for ( std::size_t offset{ 0 }; offset < 64; offset += 16 ) {
+        const auto block{ _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>( data + offset ) ) };
+        mask |= static_cast<std::uint64_t>( static_cast<std::uint16_t>(
+                    _mm_movemask_epi8( _mm_cmpeq_epi8( block, pattern ) ) ) )
+                << offset;
+    }
+    return mask;
+}
+
+[[gnu::target( "avx2" )]] inline std::uint64_t
+block_mask_avx2( const char * data, const char delim ) noexcept {
+    const auto    pattern{ _mm256_set1_epi8( delim ) };
+    std::uint64_t mask{ 0 };
+    for ( std::size_t offset{ 0 }; offset < 64; offset += 32 ) {
+        const auto block{ _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>( data + offset ) ) };
+        mask |=
+            static_cast<std::uint64_t>( static_cast<std::uint32_t>(
+                _mm256_movemask_epi8( _mm256_cmpeq_epi8( block, pattern ) ) ) )
+            << offset;
+    }
+    return mask;
+}
+
+[[gnu::target( "sse4.2" )]] inline std::size_t
+count_sse42( const char * data, const std::size_t size,
+             const char delim ) noexcept {
+    std::size_t count{ 0 };
+    std::size_t i{ 0 };
+    for ( ; i + 64 <= size; i += 64 ) {
+        count += static_cast<std::size_t>(
+            std::popcount( block_mask_sse42( data + i, delim ) ) );
+    }
+    return count + count_scalar( data, size, delim, i );
+}
+
+[[gnu::target( "sse4.2" )]] inline void
+split_sse42( const char * data, const std::size_t size, const char delim,
+             SplitCursor & cursor ) noexcept {
+    std::size_t i{ 0 };
+    for ( ; i + 64 <= size; i += 64 ) {
+        cursor.emit( data, i, block_mask_sse42( data + i, delim ), 1 );
+    }
+    split_scalar( data, size, delim, cursor, i );
+}
+
+[[gnu::target( "avx2" )]] inline std::size_t
+count_avx2( const char * data, const std::size_t size,
+            const char delim ) noexcept {
+    std::size_t count{ 0 };
+    std::size_t i{ 0 };
+    for ( ; i + 64 <= size; i += 64 ) {
+        count += static_cast<std::size_t>(
+            std::popcount( block_mask_avx2( data + i, delim ) ) );
+    }
+    return count + count_scalar( data, size, delim, i );
+}
+
+[[gnu::target( "avx2" )]] inline void
+split_avx2( const char * data, const std::size_t size, const char delim,
+            SplitCursor & cursor ) noexcept {
+    std::size_t i{ 0 };
+    for ( ; i + 64 <= size; i += 64 ) {
+        cursor.emit( data, i, block_mask_avx2( data + i, delim ), 1 );
+    }
+    split_scalar( data, size, delim, cursor, i );
+}
+
+#endif // AOC_X86_SIMD
+
+[[nodiscard]] inline ScanIsa
+detect_scan_isa() noexcept {
+#ifdef AOC_X86_SIMD
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx2" ) )
+        return ScanIsa::AVX2;
+    if ( __builtin_cpu_supports( "sse4.2" ) )
+        return ScanIsa::SSE42;
+#endif
+    return ScanIsa::Scalar;
+}
+
+} // namespace detail
+
+[[nodiscard]] inline ScanIsa
+scan_isa() noexcept {
+    static const ScanIsa isa{ detail::detect_scan_isa() };
+    return isa;
+}
+
+// Number of occurrences of delim in data
+[[nodiscard]] inline std::size_t
+count_delimiters( const std::string_view data, const char delim,
+                  const ScanIsa isa = scan_isa() ) noexcept {
+    switch ( isa ) {
+#ifdef AOC_X86_SIMD
+    case ScanIsa::AVX2:
+        return detail::count_avx2( data.data(), data.size(), delim );
+    case ScanIsa::SSE42:
+        return detail::count_sse42( data.data(), data.size(), delim );
+#endif
+    default: return detail::count_scalar( data.data(), data.size(), delim );
+    }
+}
+
+/*
+ * Splits data on every occurrence of delim, matching std::views::split:
+ *  - Empty input produces no pieces.
+ *  - A trailing delimiter produces a trailing empty piece.
+ * The output is sized exactly from a counting pass before it is filled.
+ */
+[[nodiscard]] inline std::vector<std::string_view>
+split_delimited( const std::string_view data, const char delim,
+                 const ScanIsa isa = scan_isa() ) {
+    if ( data.empty() )
+        return {};
+
+    std::vector<std::string_view> pieces(
+        count_delimiters( data, delim, isa ) + 1 );
+
+    detail::SplitCursor cursor{ data.data(), pieces.data() };
+    switch ( isa ) {
+#ifdef AOC_X86_SIMD
+    case ScanIsa::AVX2:
+        detail::split_avx2( data.data(), data.size(), delim, cursor );
+        break;
+    case ScanIsa::SSE42:
+        detail::split_sse42( data.data(), data.size(), delim, cursor );
+        break;
+#endif
+    default:
+        detail::split_scalar( data.data(), data.size(), delim, cursor );
+        break;
+    }
+    *cursor.out = std::string_view(
+        cursor.piece_start,
+        static_cast<std::size_t>( data.data() + data.size()
+                                  - cursor.piece_start ) );
+
+    return pieces;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Work-stealing thread pool.
+ *  - Every worker owns a task deque. Workers pop their own newest task
+ *    first (LIFO, cache-warm) and steal the oldest task of another
+ *    worker when they run dry (FIFO, the biggest remaining piece of
+ *    work).
+ *  - Tasks submitted from outside the pool are dealt round-robin across
+ *    the deques, tasks submitted by a worker go on its own deque.
+ *  - parallel_for blocks until every task it spawned has finished. The
+ *    waiting thread runs queued tasks in the meantime, so it can be
+ *    called from inside a task without deadlocking.
+ *  - Threads outside the pool share a single worker_index() slot, so at
+ *    most one of them may be in parallel_for at a time.
+ *  - Tasks must not throw.
+ */
+class ThreadPool
+{
+    private:
+    struct alignas( 64 ) TaskQueue
+    {
+        std::mutex                        mutex{};
+        std::deque<std::function<void()>> tasks{};
+    };
+
+    std::vector<std::unique_ptr<TaskQueue>> m_queues{};
+    std::vector<std::jthread>               m_threads{};
+    std::mutex                              m_sleep_mutex{};
+    std::condition_variable                 m_wake{};
+    std::size_t                             m_pending{ 0 };
+    bool                                    m_stopping{ false };
+    std::atomic<std::size_t>                m_next_queue{ 0 };
+
+    static inline thread_local const ThreadPool * t_pool{ nullptr };
+    static inline thread_local std::size_t        t_index{ 0 };
+
+    void push( std::function<void()> task ) {
+        const auto index{ t_pool == this ?
+                              t_index :
+                              m_next_queue.fetch_add(
+                                  1, std::memory_order_relaxed )
+                                  % m_queues.size() };
+        {
+            const std::scoped_lock lock{ m_queues[index]->mutex };
+            m_queues[index]->tasks.push_back( std::move( task ) );
+        }
+        {
+            const std::scoped_lock lock{ m_sleep_mutex };
+            ++m_pending;
+        }
+        m_wake.notify_one();
+    }
+
+    // Own deque from the back, then every other deque from the front
+    bool take( const std::size_t index, std::function<void()> & task ) {
+        const auto n_queues{ m_queues.size() };
+        for ( std::size_t offset{ 0 }; offset < n_queues; ++offset ) {
+            auto &                 queue{ *m_queues[( index + offset )
+                                                    % n_queues] };
+            const std::scoped_lock lock{ queue.mutex };
+            if ( queue.tasks.empty() )
+                continue;
+
+            if ( offset == 0 ) {
+                task = std::move( queue.tasks.back() );
+                queue.tasks.pop_back();
+            }
+            else {
+                task = std::move( queue.tasks.front() );
+                queue.tasks.pop_front();
+            }
+            const std::scoped_lock sleep_lock{ m_sleep_mutex };
+            --m_pending;
+            return true;
+        }
+        return false;
+    }
+
+    void worker_loop( const std::size_t index ) {
+        t_pool = this;
+        t_index = index;
+
+        std::function<void()> task{};
+        while ( true ) {
+            if ( take( index, task ) ) {
+                task();
+                continue;
+            }
+
+            std::unique_lock lock{ m_sleep_mutex };
+            m_wake.wait( lock,
+                         [this] { return m_stopping || m_pending > 0; } );
+            if ( m_stopping && m_pending == 0 )
+                return;
+        }
+    }
+
+    public:
+    explicit ThreadPool( const std::size_t n_threads =
+                             std::thread::hardware_concurrency() ) {
+        const auto n_workers{ std::max( n_threads, std::size_t{ 1 } ) };
+        for ( std::size_t i{ 0 }; i < n_workers; ++i ) {
+            m_queues.push_back( std::make_unique<TaskQueue>() );
+        }
+        for ( std::size_t i{ 0 }; i < n_workers; ++i ) {
+            m_threads.emplace_back( [this, i] { worker_loop( i ); } );
+        }
+    }
+
+    ThreadPool( const ThreadPool & ) = delete;
+    ThreadPool( ThreadPool && ) = delete;
+    ThreadPool & operator=( const ThreadPool & ) = delete;
+    ThreadPool & operator=( ThreadPool && ) = delete;
+
+    ~ThreadPool() {
+        {
+            const std::scoped_lock lock{ m_sleep_mutex };
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        // jthread joins on destruction, after the queues have drained
+        m_threads.clear();
+    }
+
+    [[nodiscard]] std::size_t worker_count() const noexcept {
+        return m_queues.size();
+    }
+
+    // Index of the calling worker in [0, worker_count()), or
+    // worker_count() for threads outside the pool. Sized for per-thread
+    // partial results: worker_count() + 1 slots. Every outside thread
+    // gets the same slot, see the class comment.
+    [[nodiscard]] std::size_t worker_index() const noexcept {
+        return t_pool == this ? t_index : worker_count();
+    }
+
+    template <typename F>
+    void submit( F && function ) {
+        push( std::function<void()>( std::forward<F>( function ) ) );
+    }
+
+    // Runs function( i ) for every i in [0, count) and waits for them all.
+    // At most one thread outside the pool may be waiting here at a time.
+    template <typename F>
+    void parallel_for( const std::size_t count, F && function ) {
+        if ( count == 0 )
+            return;
+
+        std::latch done{ static_cast<std::ptrdiff_t>( count ) };
+        for ( std::size_t i{ 0 }; i < count; ++i ) {
+            push( [&function, &done, i] {
+                function( i );
+                done.count_down();
+            } );
+        }
+
+        const auto            helper_index{ t_pool == this ? t_index : 0 };
+        std::function<void()> task{};
+        while ( !done.try_wait() ) {
+            if ( take( helper_index, task ) )
+                task();
+            else
+                std::this_thread::yield();
+        }
+    }
+};